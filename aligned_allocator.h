@@ -0,0 +1,43 @@
+#ifndef ALIGNED_ALLOCATOR_H
+#define ALIGNED_ALLOCATOR_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+// Allocator returning storage aligned to Alignment bytes (32 for AVX2, 64
+// for AVX-512 and cache lines). my_vector reads the alignment member to
+// pad its capacity to whole vectors and to type aligned_data().
+template <typename T, size_t Alignment>
+class aligned_allocator {
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+    static_assert(Alignment >= alignof(T), "Alignment must not be weaker than the element's own");
+
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+    static constexpr size_t alignment = Alignment;
+
+    template <typename U>
+    struct rebind {
+        using other = aligned_allocator<U, (Alignment > alignof(U) ? Alignment : alignof(U))>;
+    };
+
+    aligned_allocator () noexcept = default;
+    template <typename U, size_t A>
+    explicit aligned_allocator (const aligned_allocator<U, A>&) noexcept {}
+
+    [[nodiscard]] T* allocate (const size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate (T* p, size_t) noexcept {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U, size_t A>
+    friend bool operator==(const aligned_allocator&, const aligned_allocator<U, A>&) noexcept {
+        return true;
+    }
+};
+
+#endif //ALIGNED_ALLOCATOR_H
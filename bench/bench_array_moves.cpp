@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+#include <array>
+#include <string>
+#include <utility>
+#include "../my_array.h"
+
+// moves of string arrays (pointer steals, nothing left to clear in the
+// source) and copies of small int arrays (a trivially copyable my_array
+// is a plain register/memcpy copy), next to std::array
+
+static_assert(std::is_trivially_copyable_v<my_array<int, 4>>);
+
+template <typename Array>
+static void BM_move_strings(benchmark::State& state) {
+    Array a;
+    a.fill(std::string(64, 'x'));
+    for (auto _ : state) {
+        Array b(std::move(a));
+        benchmark::DoNotOptimize(b);
+        a = std::move(b);
+        benchmark::DoNotOptimize(a);
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+template <typename Array>
+[[gnu::noinline]] static int sum_by_value (const Array a) {
+    return a[0] + a[1] + a[2] + a[3];
+}
+
+template <typename Array>
+static void BM_copy_ints(benchmark::State& state) {
+    Array a;
+    a.fill(3);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        Array b(a);
+        benchmark::DoNotOptimize(b);
+    }
+}
+
+// a trivially copyable array is passed in registers instead of through
+// a hidden copy in memory
+template <typename Array>
+static void BM_pass_ints_by_value(benchmark::State& state) {
+    Array a;
+    a.fill(3);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(sum_by_value(a));
+    }
+}
+
+BENCHMARK(BM_move_strings<my_array<std::string, 64>>);
+BENCHMARK(BM_move_strings<std::array<std::string, 64>>);
+BENCHMARK(BM_copy_ints<my_array<int, 4>>);
+BENCHMARK(BM_copy_ints<std::array<int, 4>>);
+BENCHMARK(BM_pass_ints_by_value<my_array<int, 4>>);
+BENCHMARK(BM_pass_ints_by_value<std::array<int, 4>>);
+
+BENCHMARK_MAIN();
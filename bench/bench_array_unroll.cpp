@@ -0,0 +1,162 @@
+#include <benchmark/benchmark.h>
+#include <compare>
+#include "../my_array.h"
+
+// my_array<int, N> operations next to the same operations hand-written on
+// a plain int[N]; with the index_sequence unrolling both should compile to
+// the same straight-line code for N up to my_array_unroll_limit
+
+template <size_t N>
+struct raw_array {
+    int v[N];
+};
+
+template <size_t N>
+static void BM_my_array_copy(benchmark::State& state) {
+    my_array<int, N> a(7);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        my_array<int, N> b(a);
+        benchmark::DoNotOptimize(b);
+    }
+}
+template <size_t N>
+static void BM_raw_copy(benchmark::State& state) {
+    raw_array<N> a;
+    for (int& x : a.v) {
+        x = 7;
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        raw_array<N> b;
+        for (size_t i = 0; i < N; ++i) {
+            b.v[i] = a.v[i];
+        }
+        benchmark::DoNotOptimize(b);
+    }
+}
+
+template <size_t N>
+static void BM_my_array_fill(benchmark::State& state) {
+    my_array<int, N> a;
+    int value = 3;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(value);
+        a.fill(value);
+        benchmark::DoNotOptimize(a);
+    }
+}
+template <size_t N>
+static void BM_raw_fill(benchmark::State& state) {
+    raw_array<N> a {};
+    int value = 3;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(value);
+        for (size_t i = 0; i < N; ++i) {
+            a.v[i] = value;
+        }
+        benchmark::DoNotOptimize(a);
+    }
+}
+
+template <size_t N>
+static void BM_my_array_equal(benchmark::State& state) {
+    my_array<int, N> a(5);
+    my_array<int, N> b(5);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+        benchmark::DoNotOptimize(a == b);
+    }
+}
+template <size_t N>
+static void BM_raw_equal(benchmark::State& state) {
+    raw_array<N> a;
+    raw_array<N> b;
+    for (size_t i = 0; i < N; ++i) {
+        a.v[i] = b.v[i] = 5;
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+        bool equal = true;
+        for (size_t i = 0; i < N; ++i) {
+            equal = equal && a.v[i] == b.v[i];
+        }
+        benchmark::DoNotOptimize(equal);
+    }
+}
+
+// the arrays differ only in the last element, so every element is compared
+template <size_t N>
+static void BM_my_array_compare(benchmark::State& state) {
+    my_array<int, N> a(5);
+    my_array<int, N> b(5);
+    b[N - 1] = 6;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+        benchmark::DoNotOptimize(a < b);
+    }
+}
+template <size_t N>
+static void BM_raw_compare(benchmark::State& state) {
+    raw_array<N> a;
+    raw_array<N> b;
+    for (size_t i = 0; i < N; ++i) {
+        a.v[i] = b.v[i] = 5;
+    }
+    b.v[N - 1] = 6;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+        std::strong_ordering order = std::strong_ordering::equal;
+        for (size_t i = 0; i < N && order == 0; ++i) {
+            order = a.v[i] <=> b.v[i];
+        }
+        benchmark::DoNotOptimize(order < 0);
+    }
+}
+
+template <size_t N>
+static void BM_my_array_swap(benchmark::State& state) {
+    my_array<int, N> a(1);
+    my_array<int, N> b(2);
+    for (auto _ : state) {
+        a.swap(b);
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+    }
+}
+template <size_t N>
+static void BM_raw_swap(benchmark::State& state) {
+    raw_array<N> a {};
+    raw_array<N> b {};
+    for (auto _ : state) {
+        for (size_t i = 0; i < N; ++i) {
+            const int t = a.v[i];
+            a.v[i] = b.v[i];
+            b.v[i] = t;
+        }
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+    }
+}
+
+#define UNROLL_BENCHMARKS(N)                \
+    BENCHMARK(BM_my_array_copy<N>);         \
+    BENCHMARK(BM_raw_copy<N>);              \
+    BENCHMARK(BM_my_array_fill<N>);         \
+    BENCHMARK(BM_raw_fill<N>);              \
+    BENCHMARK(BM_my_array_equal<N>);        \
+    BENCHMARK(BM_raw_equal<N>);             \
+    BENCHMARK(BM_my_array_compare<N>);      \
+    BENCHMARK(BM_raw_compare<N>);           \
+    BENCHMARK(BM_my_array_swap<N>);         \
+    BENCHMARK(BM_raw_swap<N>);
+
+UNROLL_BENCHMARKS(4)
+UNROLL_BENCHMARKS(8)
+UNROLL_BENCHMARKS(16)
+
+BENCHMARK_MAIN();
@@ -0,0 +1,131 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <string>
+#include "../my_gap_vector.h"
+#include "../my_vector.h"
+
+// Editing near a cursor that drifts slowly through the buffer: each step
+// moves the cursor a few places and inserts or erases there. my_vector
+// shifts the whole tail on every edit, my_gap_vector only the distance the
+// cursor moved.
+
+// the cursor movement and edit kind for one step, from a fixed xorshift
+// sequence so both containers see the same edits
+struct edit_script {
+    uint64_t state_m = 88172645463325252ull;
+
+    uint64_t next () {
+        state_m ^= state_m << 13;
+        state_m ^= state_m >> 7;
+        state_m ^= state_m << 17;
+        return state_m;
+    }
+};
+
+constexpr size_t edits_per_run = 10'000;
+
+static size_t move_cursor (edit_script& script, size_t cursor, const size_t size) {
+    const uint64_t r = script.next();
+    const auto step = static_cast<ptrdiff_t>(r % 9) - 4;
+    if (step < 0 && cursor < static_cast<size_t>(-step)) {
+        return 0;
+    }
+    cursor += step;
+    return cursor > size ? size : cursor;
+}
+
+template <typename T>
+static T make_value (const size_t i) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        return std::string(24, static_cast<char>('a' + i % 26));
+    } else {
+        return static_cast<T>(i);
+    }
+}
+
+template <typename T>
+static void BM_vector_cursor_edits(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        my_vector<T> v;
+        for (size_t i = 0; i < n; ++i) {
+            v.push_back(make_value<T>(i));
+        }
+        edit_script script;
+        size_t cursor = n / 2;
+        state.ResumeTiming();
+        for (size_t e = 0; e < edits_per_run; ++e) {
+            cursor = move_cursor(script, cursor, v.size());
+            if (script.next() % 3 != 0 || cursor == v.size()) {
+                v.insert(v.begin() + cursor, make_value<T>(e));
+            } else {
+                v.erase(v.begin() + cursor);
+            }
+        }
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * edits_per_run));
+}
+
+template <typename T>
+static void BM_gap_cursor_edits(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        my_gap_vector<T> v;
+        for (size_t i = 0; i < n; ++i) {
+            v.push_back(make_value<T>(i));
+        }
+        edit_script script;
+        size_t cursor = n / 2;
+        state.ResumeTiming();
+        for (size_t e = 0; e < edits_per_run; ++e) {
+            cursor = move_cursor(script, cursor, v.size());
+            if (script.next() % 3 != 0 || cursor == v.size()) {
+                v.insert(cursor, make_value<T>(e));
+            } else {
+                v.erase(cursor);
+            }
+        }
+        benchmark::DoNotOptimize(v.contiguous().data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * edits_per_run));
+}
+
+// the price of the gap on reads: a full scan through operator[]
+template <typename V>
+static void BM_indexed_scan(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    V v;
+    for (size_t i = 0; i < n; ++i) {
+        v.push_back(static_cast<int>(i));
+    }
+    if constexpr (std::is_same_v<V, my_gap_vector<int>>) {
+        v.insert(n / 2, 0); // leaves the gap in the middle
+    }
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (size_t i = 0; i < v.size(); ++i) {
+            sum += v[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+static void sizes(benchmark::internal::Benchmark* b) {
+    for (const int64_t n : {1'000, 100'000, 1'000'000}) {
+        b->Arg(n);
+    }
+    b->Unit(benchmark::kMicrosecond);
+}
+
+BENCHMARK(BM_vector_cursor_edits<int>)->Apply(sizes);
+BENCHMARK(BM_gap_cursor_edits<int>)->Apply(sizes);
+BENCHMARK(BM_vector_cursor_edits<std::string>)->Apply(sizes);
+BENCHMARK(BM_gap_cursor_edits<std::string>)->Apply(sizes);
+BENCHMARK(BM_indexed_scan<my_vector<int>>)->Apply(sizes);
+BENCHMARK(BM_indexed_scan<my_gap_vector<int>>)->Apply(sizes);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include "../my_vector.h"
+
+static size_t allocations = 0;
+static size_t live_bytes = 0;
+static size_t peak_bytes = 0;
+
+// std::allocator that records what the vector asks for
+template <typename T>
+struct counting_allocator : std::allocator<T> {
+    template <typename U>
+    struct rebind {
+        using other = counting_allocator<U>;
+    };
+
+    counting_allocator () = default;
+    template <typename U>
+    counting_allocator (const counting_allocator<U>&) noexcept {}
+
+    T* allocate (const size_t n) {
+        ++allocations;
+        live_bytes += n * sizeof(T);
+        peak_bytes = std::max(peak_bytes, live_bytes);
+        return std::allocator<T>::allocate(n);
+    }
+    void deallocate (T* p, const size_t n) noexcept {
+        live_bytes -= n * sizeof(T);
+        std::allocator<T>::deallocate(p, n);
+    }
+};
+
+template <typename V, typename E>
+static void BM_growth(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    size_t allocs = 0;
+    size_t peak = 0;
+    for (auto _ : state) {
+        allocations = 0;
+        peak_bytes = live_bytes;
+        const size_t base = live_bytes;
+        {
+            V v;
+            for (size_t i = 0; i < n; ++i) {
+                v.emplace_back(E());
+            }
+            benchmark::DoNotOptimize(v.begin());
+        }
+        allocs = allocations;
+        peak = peak_bytes - base;
+    }
+    state.counters["allocs"] = static_cast<double>(allocs);
+    state.counters["peak_bytes"] = static_cast<double>(peak);
+    state.counters["bytes_per_elem"] = static_cast<double>(peak) / static_cast<double>(n);
+}
+
+#define GROWTH_BENCHMARKS(E)                                                                    \
+    BENCHMARK(BM_growth<my_vector<E, growth_factor_2, counting_allocator<E>>, E>)->RangeMultiplier(8)->Range(64, 1 << 21);   \
+    BENCHMARK(BM_growth<my_vector<E, growth_factor_1_5, counting_allocator<E>>, E>)->RangeMultiplier(8)->Range(64, 1 << 21); \
+    BENCHMARK(BM_growth<my_vector<E, growth_page_aligned<>, counting_allocator<E>>, E>)->RangeMultiplier(8)->Range(64, 1 << 21);
+
+GROWTH_BENCHMARKS(int)
+GROWTH_BENCHMARKS(std::string)
+
+BENCHMARK_MAIN();
@@ -0,0 +1,93 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include "../huge_page_allocator.h"
+#include "../my_vector.h"
+
+// random operator[] over vectors far larger than the TLB reach of 4 KiB
+// pages, with the storage on 4 KiB pages, transparent huge pages and
+// hugetlb pages (which fall back to transparent ones without a pool)
+
+using small_pages = my_vector<uint64_t>;
+using transparent_pages = my_vector<uint64_t, growth_factor_2, huge_page_allocator<uint64_t>>;
+using hugetlb_pages = my_vector<uint64_t, growth_factor_2,
+                                huge_page_allocator<uint64_t, size_t(32) << 20, huge_page_mode::hugetlb>>;
+
+template <typename Vector>
+static Vector make_vector (const size_t n) {
+    Vector v;
+    v.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        v[i] = i * 0x9E3779B97F4A7C15ull;
+    }
+    return v;
+}
+
+// independent random reads: throughput bound by page walks
+template <typename Vector>
+static void BM_random_read(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const Vector v = make_vector<Vector>(n);
+    uint64_t x = 88172645463325252ull;
+    constexpr size_t reads = 1 << 20;
+    for (auto _ : state) {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < reads; ++i) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            sum += v[x % n];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * reads));
+}
+
+// dependent random reads: each index comes from the previous element, so
+// every TLB miss is on the critical path
+template <typename Vector>
+static void BM_random_chase(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const Vector v = make_vector<Vector>(n);
+    uint64_t index = 0;
+    constexpr size_t reads = 1 << 18;
+    for (auto _ : state) {
+        for (size_t i = 0; i < reads; ++i) {
+            index = (v[index] ^ i) % n;
+        }
+        benchmark::DoNotOptimize(index);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * reads));
+}
+
+// push_back growth, where huge_page_allocator can extend in place with mremap
+template <typename Vector>
+static void BM_push_back(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        Vector v;
+        for (size_t i = 0; i < n; ++i) {
+            v.push_back(i);
+        }
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+// 64 MiB to 2 GiB of uint64_t
+static void sizes(benchmark::internal::Benchmark* b) {
+    for (const int64_t n : {int64_t(1) << 23, int64_t(1) << 26, int64_t(1) << 28}) {
+        b->Arg(n);
+    }
+    b->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK(BM_random_read<small_pages>)->Apply(sizes);
+BENCHMARK(BM_random_read<transparent_pages>)->Apply(sizes);
+BENCHMARK(BM_random_read<hugetlb_pages>)->Apply(sizes);
+BENCHMARK(BM_random_chase<small_pages>)->Apply(sizes);
+BENCHMARK(BM_random_chase<transparent_pages>)->Apply(sizes);
+BENCHMARK(BM_random_chase<hugetlb_pages>)->Apply(sizes);
+BENCHMARK(BM_push_back<small_pages>)->Apply(sizes);
+BENCHMARK(BM_push_back<transparent_pages>)->Apply(sizes);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,52 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+#include "../my_array.h"
+#include "../my_vector.h"
+
+enum position { front, middle, back };
+
+// insert one element and erase it again, so the size stays at n
+template <typename V>
+static void BM_insert_erase(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const auto where = static_cast<position>(state.range(1));
+    V v;
+    for (size_t i = 0; i < n; ++i) {
+        v.push_back(static_cast<int>(i));
+    }
+    const size_t index = where == front ? 0 : where == middle ? n / 2 : n;
+    for (auto _ : state) {
+        v.insert(v.begin() + index, 42);
+        benchmark::DoNotOptimize(v.begin());
+        v.erase(v.begin() + index);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>((n - index) * sizeof(int) * 2));
+}
+
+template <size_t N>
+static void BM_array_insert_erase(benchmark::State& state) {
+    const auto where = static_cast<position>(state.range(0));
+    my_array<int, N> a(7);
+    const size_t index = where == front ? 0 : where == middle ? N / 2 : N - 1;
+    for (auto _ : state) {
+        a.insert(a.begin() + index, 42);
+        benchmark::DoNotOptimize(a.begin());
+        a.erase(a.begin() + index);
+    }
+}
+
+static void positions(benchmark::internal::Benchmark* b) {
+    for (const int64_t n : {1 << 10, 1 << 16, 1 << 20}) {
+        for (const int64_t where : {front, middle, back}) {
+            b->Args({n, where});
+        }
+    }
+}
+
+BENCHMARK(BM_insert_erase<my_vector<int>>)->Apply(positions);
+BENCHMARK(BM_insert_erase<std::vector<int>>)->Apply(positions);
+BENCHMARK(BM_array_insert_erase<1024>)->DenseRange(front, back);
+BENCHMARK(BM_array_insert_erase<65536>)->DenseRange(front, back);
+
+BENCHMARK_MAIN();
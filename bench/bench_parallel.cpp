@@ -0,0 +1,252 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <string>
+#include <string_view>
+#include "../my_parallel.h"
+#include "../my_vector.h"
+
+#ifdef HAVE_TBB
+#include <execution>
+#include <tbb/global_control.h>
+#endif
+
+// my_parallel.h against the std::execution::par algorithms (libstdc++
+// runs those on TBB, so they are only built when TBB is found). The
+// thread count is the second argument; both sides are capped to it, the
+// pool with one worker less because the calling thread joins in.
+
+struct record {
+    double key;
+    int64_t id;
+    double payload[6];
+};
+
+template <typename E>
+static E make_element (const uint64_t x) {
+    if constexpr (std::is_same_v<E, record>) {
+        record r{};
+        r.key = static_cast<double>(x % 1'000'000);
+        r.id = static_cast<int64_t>(x);
+        return r;
+    } else if constexpr (std::is_same_v<E, std::string>) {
+        // past the small string buffer, so a sort moves heap pointers
+        return std::to_string(x % 1'000'000) + " key padded past the small string buffer";
+    } else {
+        return static_cast<E>(x % 1'000'000);
+    }
+}
+
+template <typename E>
+static auto key (const E& e) {
+    if constexpr (std::is_same_v<E, record>) {
+        return e.key;
+    } else if constexpr (std::is_same_v<E, std::string>) {
+        return std::string_view(e);
+    } else {
+        return e;
+    }
+}
+
+struct by_key {
+    template <typename E>
+    bool operator()(const E& a, const E& b) const {
+        return key(a) < key(b);
+    }
+};
+
+template <typename E>
+static my_vector<E> shuffled (const size_t n) {
+    std::mt19937_64 rng(42);
+    my_vector<E> v;
+    v.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        v.push_back(make_element<E>(rng()));
+    }
+    return v;
+}
+
+static size_t threads (const benchmark::State& state) {
+    return static_cast<size_t>(state.range(1));
+}
+
+// sort
+
+template <typename E, bool Stable>
+static void BM_my_sort(benchmark::State& state) {
+    const my_vector<E> src = shuffled<E>(static_cast<size_t>(state.range(0)));
+    thread_pool pool(threads(state) - 1);
+    my_vector<E> v;
+    for (auto _ : state) {
+        state.PauseTiming();
+        v = src;
+        state.ResumeTiming();
+        if constexpr (Stable) {
+            parallel_stable_sort(v, by_key(), pool);
+        } else {
+            parallel_sort(v, by_key(), pool);
+        }
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// transform
+
+template <typename E>
+static double scaled (const E& e) {
+    return key(e) * 1.5 + 1.0;
+}
+
+template <typename E>
+static void BM_my_transform(benchmark::State& state) {
+    const my_vector<E> src = shuffled<E>(static_cast<size_t>(state.range(0)));
+    my_vector<double> dst(src.size(), 0.0);
+    thread_pool pool(threads(state) - 1);
+    for (auto _ : state) {
+        parallel_transform(src, dst, scaled<E>, pool);
+        benchmark::DoNotOptimize(dst.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// reduce
+
+static void BM_my_reduce(benchmark::State& state) {
+    const my_vector<double> v = shuffled<double>(static_cast<size_t>(state.range(0)));
+    thread_pool pool(threads(state) - 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parallel_reduce(v, 0.0, std::plus<>(), pool));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// count_if and find_if; the searched element sits at the very end
+
+template <typename E>
+static void BM_my_count_if(benchmark::State& state) {
+    const my_vector<E> v = shuffled<E>(static_cast<size_t>(state.range(0)));
+    thread_pool pool(threads(state) - 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parallel_count_if(v, [](const E& e) { return key(e) < 500'000.0; }, pool));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_my_find_if(benchmark::State& state) {
+    my_vector<record> v = shuffled<record>(static_cast<size_t>(state.range(0)));
+    v.back().key = -1.0;
+    thread_pool pool(threads(state) - 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parallel_find_if(v, [](const record& r) { return r.key < 0.0; }, pool));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#ifdef HAVE_TBB
+static tbb::global_control limit_threads (const benchmark::State& state) {
+    return tbb::global_control(tbb::global_control::max_allowed_parallelism, threads(state));
+}
+
+template <typename E, bool Stable>
+static void BM_std_sort(benchmark::State& state) {
+    const my_vector<E> src = shuffled<E>(static_cast<size_t>(state.range(0)));
+    const auto limit = limit_threads(state);
+    my_vector<E> v;
+    for (auto _ : state) {
+        state.PauseTiming();
+        v = src;
+        state.ResumeTiming();
+        if constexpr (Stable) {
+            std::stable_sort(std::execution::par, v.begin(), v.end(), by_key());
+        } else {
+            std::sort(std::execution::par, v.begin(), v.end(), by_key());
+        }
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename E>
+static void BM_std_transform(benchmark::State& state) {
+    const my_vector<E> src = shuffled<E>(static_cast<size_t>(state.range(0)));
+    my_vector<double> dst(src.size(), 0.0);
+    const auto limit = limit_threads(state);
+    for (auto _ : state) {
+        std::transform(std::execution::par, src.begin(), src.end(), dst.begin(), scaled<E>);
+        benchmark::DoNotOptimize(dst.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_std_reduce(benchmark::State& state) {
+    const my_vector<double> v = shuffled<double>(static_cast<size_t>(state.range(0)));
+    const auto limit = limit_threads(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::reduce(std::execution::par, v.begin(), v.end(), 0.0));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename E>
+static void BM_std_count_if(benchmark::State& state) {
+    const my_vector<E> v = shuffled<E>(static_cast<size_t>(state.range(0)));
+    const auto limit = limit_threads(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::count_if(std::execution::par, v.begin(), v.end(),
+                                               [](const E& e) { return key(e) < 500'000.0; }));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_std_find_if(benchmark::State& state) {
+    my_vector<record> v = shuffled<record>(static_cast<size_t>(state.range(0)));
+    v.back().key = -1.0;
+    const auto limit = limit_threads(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::find_if(std::execution::par, v.begin(), v.end(),
+                                              [](const record& r) { return r.key < 0.0; }));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+#endif
+
+static void thread_counts(benchmark::internal::Benchmark* b) {
+    for (const int64_t n : {100'000, 10'000'000}) {
+        for (const int64_t t : {1, 2, 4, 8, 16, 32, 64}) {
+            b->Args({n, t});
+        }
+    }
+    b->ArgNames({"n", "threads"});
+    b->Unit(benchmark::kMillisecond);
+    b->UseRealTime();
+}
+
+BENCHMARK(BM_my_sort<double, false>)->Apply(thread_counts);
+BENCHMARK(BM_my_sort<record, false>)->Apply(thread_counts);
+BENCHMARK(BM_my_sort<double, true>)->Apply(thread_counts);
+BENCHMARK(BM_my_sort<record, true>)->Apply(thread_counts);
+BENCHMARK(BM_my_sort<std::string, false>)->Apply(thread_counts);
+BENCHMARK(BM_my_transform<double>)->Apply(thread_counts);
+BENCHMARK(BM_my_transform<record>)->Apply(thread_counts);
+BENCHMARK(BM_my_reduce)->Apply(thread_counts);
+BENCHMARK(BM_my_count_if<record>)->Apply(thread_counts);
+BENCHMARK(BM_my_find_if)->Apply(thread_counts);
+
+#ifdef HAVE_TBB
+BENCHMARK(BM_std_sort<double, false>)->Apply(thread_counts);
+BENCHMARK(BM_std_sort<record, false>)->Apply(thread_counts);
+BENCHMARK(BM_std_sort<double, true>)->Apply(thread_counts);
+BENCHMARK(BM_std_sort<record, true>)->Apply(thread_counts);
+BENCHMARK(BM_std_sort<std::string, false>)->Apply(thread_counts);
+BENCHMARK(BM_std_transform<double>)->Apply(thread_counts);
+BENCHMARK(BM_std_transform<record>)->Apply(thread_counts);
+BENCHMARK(BM_std_reduce)->Apply(thread_counts);
+BENCHMARK(BM_std_count_if<record>)->Apply(thread_counts);
+BENCHMARK(BM_std_find_if)->Apply(thread_counts);
+#endif
+
+BENCHMARK_MAIN();
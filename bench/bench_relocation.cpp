@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+#include "../my_vector.h"
+
+// std::string with a move constructor that may throw, so growth has to
+// fall back to copying -- the behaviour before move-based relocation
+struct copied_string {
+    std::string s;
+    copied_string() = default;
+    explicit copied_string(std::string v) : s(std::move(v)) {}
+    copied_string(const copied_string&) = default;
+    copied_string(copied_string&& other) noexcept(false) : s(std::move(other.s)) {}
+    copied_string& operator=(const copied_string&) = default;
+    copied_string& operator=(copied_string&&) = default;
+};
+
+// trivially relocatable, but not trivially copyable
+struct owning_handle {
+    int* p;
+    owning_handle() : p(new int(0)) {}
+    owning_handle(const owning_handle& other) : p(new int(*other.p)) {}
+    owning_handle(owning_handle&& other) noexcept : p(other.p) { other.p = nullptr; }
+    owning_handle& operator=(owning_handle other) noexcept { std::swap(p, other.p); return *this; }
+    ~owning_handle() { delete p; }
+};
+
+template <>
+struct is_trivially_relocatable<owning_handle> : std::true_type {};
+
+static const std::string payload(48, 'x');
+
+template <typename V>
+static void BM_push_back_int(benchmark::State& state) {
+    for (auto _ : state) {
+        V v;
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            v.push_back(static_cast<int>(i));
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename V, typename E>
+static void BM_push_back_string(benchmark::State& state) {
+    for (auto _ : state) {
+        V v;
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            v.push_back(E(payload));
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename V>
+static void BM_push_back_handle(benchmark::State& state) {
+    for (auto _ : state) {
+        V v;
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            v.push_back(owning_handle());
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_push_back_int<my_vector<int>>)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_push_back_int<std::vector<int>>)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_push_back_string<my_vector<std::string>, std::string>)->Range(1 << 10, 1 << 18);
+BENCHMARK(BM_push_back_string<my_vector<copied_string>, copied_string>)->Range(1 << 10, 1 << 18);
+BENCHMARK(BM_push_back_string<std::vector<std::string>, std::string>)->Range(1 << 10, 1 << 18);
+BENCHMARK(BM_push_back_handle<my_vector<owning_handle>>)->Range(1 << 10, 1 << 18);
+BENCHMARK(BM_push_back_handle<std::vector<owning_handle>>)->Range(1 << 10, 1 << 18);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,179 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../my_ring.h"
+#include "../my_vector.h"
+
+// Handoff between pipeline threads: my_ring in spsc and mpmc mode next to
+// the mutex-guarded my_vector it replaces. Throughput runs move a fixed
+// number of items from P producers to P consumers; the latency run bounces
+// one item between two threads.
+
+constexpr size_t ring_capacity = 1024;
+constexpr long items_per_run = 1 << 20;
+
+using spsc_ring = my_ring<long, ring_capacity, ring_mode::spsc>;
+using mpmc_ring = my_ring<long, ring_capacity, ring_mode::mpmc>;
+
+// the current approach: producers append under a lock, a consumer swaps
+// the whole vector out
+class locked_vector {
+    std::mutex mutex_m;
+    my_vector<long> items_m;
+
+public:
+    size_t push_n (const long* src, const size_t count) {
+        std::lock_guard lock(mutex_m);
+        items_m.insert(items_m.end(), src, src + count);
+        return count;
+    }
+    size_t pop_all (my_vector<long>& out) {
+        out.clear();
+        std::lock_guard lock(mutex_m);
+        items_m.swap(out);
+        return out.size();
+    }
+};
+
+template <typename Ring>
+static size_t pop_some (Ring& ring, my_vector<long>& buffer, const size_t batch) {
+    buffer.resize(batch);
+    const size_t n = ring.pop_n(buffer.data(), batch);
+    buffer.resize(n);
+    return n;
+}
+static size_t pop_some (locked_vector& queue, my_vector<long>& buffer, size_t) {
+    return queue.pop_all(buffer);
+}
+
+// producers push items_per_run values in batches of `batch`, consumers
+// pop until all have arrived; returns the checksum so nothing is elided
+template <typename Queue>
+static long run_transfer (Queue& queue, const int producers, const int consumers, const size_t batch) {
+    const long per_producer = items_per_run / producers;
+    const long total = per_producer * producers;
+    std::atomic<long> received {0};
+    std::atomic<long> checksum {0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&] {
+            std::vector<long> values(batch, 1);
+            for (long sent = 0; sent < per_producer;) {
+                const auto want = static_cast<size_t>(std::min<long>(static_cast<long>(batch), per_producer - sent));
+                const size_t n = queue.push_n(values.data(), want);
+                if (n == 0) {
+                    std::this_thread::yield();
+                }
+                sent += static_cast<long>(n);
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            my_vector<long> buffer;
+            long local = 0;
+            while (received.load(std::memory_order_relaxed) < total) {
+                const size_t n = pop_some(queue, buffer, batch);
+                if (n == 0) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                for (const long v : buffer) {
+                    local += v;
+                }
+                received.fetch_add(static_cast<long>(n), std::memory_order_relaxed);
+            }
+            checksum.fetch_add(local);
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    return checksum.load();
+}
+
+// range(0): total threads, split evenly between producers and consumers
+// (one thread pushes and pops in turn); range(1): batch size
+template <typename Queue>
+static void BM_throughput(benchmark::State& state) {
+    const auto threads = static_cast<int>(state.range(0));
+    const auto batch = static_cast<size_t>(state.range(1));
+    for (auto _ : state) {
+        auto queue = std::make_unique<Queue>();
+        if (threads == 1) {
+            std::vector<long> values(batch, 1);
+            my_vector<long> buffer;
+            long sum = 0;
+            for (long moved = 0; moved < items_per_run;) {
+                queue->push_n(values.data(), batch);
+                const size_t n = pop_some(*queue, buffer, batch);
+                for (const long v : buffer) {
+                    sum += v;
+                }
+                moved += static_cast<long>(n);
+            }
+            benchmark::DoNotOptimize(sum);
+        } else {
+            benchmark::DoNotOptimize(run_transfer(*queue, threads / 2, threads / 2, batch));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * items_per_run);
+}
+
+// one value bounced between two threads through a pair of rings
+template <typename Ring>
+static void BM_round_trip_latency(benchmark::State& state) {
+    constexpr long trips = 1 << 14;
+    for (auto _ : state) {
+        auto ping = std::make_unique<Ring>();
+        auto pong = std::make_unique<Ring>();
+        std::thread echo([&] {
+            for (long i = 0; i < trips; ++i) {
+                long v;
+                while (!ping->try_pop(v)) {
+                    std::this_thread::yield();
+                }
+                while (!pong->try_push(v + 1)) {}
+            }
+        });
+        long v = 0;
+        for (long i = 0; i < trips; ++i) {
+            while (!ping->try_push(v)) {}
+            while (!pong->try_pop(v)) {
+                std::this_thread::yield();
+            }
+        }
+        echo.join();
+        benchmark::DoNotOptimize(v);
+    }
+    // items_per_second is round trips per second
+    state.SetItemsProcessed(state.iterations() * trips);
+}
+
+static void spsc_args(benchmark::internal::Benchmark* b) {
+    for (const int batch : {1, 32}) {
+        b->Args({1, batch});
+        b->Args({2, batch});
+    }
+    b->UseRealTime()->Unit(benchmark::kMillisecond);
+}
+static void mpmc_args(benchmark::internal::Benchmark* b) {
+    for (const int batch : {1, 32}) {
+        for (const int threads : {1, 2, 4, 8, 16}) {
+            b->Args({threads, batch});
+        }
+    }
+    b->UseRealTime()->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK(BM_throughput<spsc_ring>)->Apply(spsc_args);
+BENCHMARK(BM_throughput<mpmc_ring>)->Apply(mpmc_args);
+BENCHMARK(BM_throughput<locked_vector>)->Apply(mpmc_args);
+BENCHMARK(BM_round_trip_latency<spsc_ring>)->UseRealTime();
+BENCHMARK(BM_round_trip_latency<mpmc_ring>)->UseRealTime();
+
+BENCHMARK_MAIN();
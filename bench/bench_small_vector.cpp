@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include "../my_small_vector.h"
+
+// build, read and drop a vector of n elements -- the typical lifetime of
+// a short per-record vector
+template <typename V>
+static void BM_build_and_sum(benchmark::State& state) {
+    const auto n = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        V v;
+        for (int i = 0; i < n; ++i) {
+            v.push_back(i);
+        }
+        int sum = 0;
+        for (const int x : v) {
+            sum += x;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename V>
+static void BM_copy(benchmark::State& state) {
+    V src;
+    for (int i = 0; i < state.range(0); ++i) {
+        src.push_back(i);
+    }
+    for (auto _ : state) {
+        V copy(src);
+        benchmark::DoNotOptimize(copy.begin());
+    }
+}
+
+template <typename V>
+static void BM_build_strings(benchmark::State& state) {
+    const auto n = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        V v;
+        for (int i = 0; i < n; ++i) {
+            v.emplace_back("short");
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void sizes(benchmark::internal::Benchmark* b) {
+    for (const int n : {0, 1, 4, 8, 15, 16, 17, 32, 64}) {
+        b->Arg(n);
+    }
+}
+
+BENCHMARK(BM_build_and_sum<my_vector<int>>)->Apply(sizes);
+BENCHMARK(BM_build_and_sum<my_small_vector<int, 16>>)->Apply(sizes);
+BENCHMARK(BM_copy<my_vector<int>>)->Apply(sizes);
+BENCHMARK(BM_copy<my_small_vector<int, 16>>)->Apply(sizes);
+BENCHMARK(BM_build_strings<my_vector<std::string>>)->Apply(sizes);
+BENCHMARK(BM_build_strings<my_small_vector<std::string, 16>>)->Apply(sizes);
+
+BENCHMARK_MAIN();
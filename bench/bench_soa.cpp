@@ -0,0 +1,147 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include "../my_soa_vector.h"
+#include "../my_vector.h"
+
+// single- and two-field scans over the same records stored as an array
+// of structs (my_vector<record>) and as a structure of arrays
+
+struct record {
+    int64_t id;
+    double x;
+    double y;
+    double z;
+    uint32_t flags;
+};
+
+using soa = my_soa_vector<int64_t, double, double, double, uint32_t>;
+
+static my_vector<record> make_aos (const size_t n) {
+    my_vector<record> v;
+    v.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        const auto d = static_cast<double>(i);
+        v.push_back(record {static_cast<int64_t>(i), d, d * 0.5, d * 0.25, static_cast<uint32_t>(i & 7)});
+    }
+    return v;
+}
+
+static soa make_soa (const size_t n) {
+    soa v;
+    v.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        const auto d = static_cast<double>(i);
+        v.emplace_back(static_cast<int64_t>(i), d, d * 0.5, d * 0.25, static_cast<uint32_t>(i & 7));
+    }
+    return v;
+}
+
+static void BM_aos_sum_x(benchmark::State& state) {
+    const my_vector<record> v = make_aos(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        double sum = 0;
+        for (const record& r : v) {
+            sum += r.x;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_soa_sum_x(benchmark::State& state) {
+    const soa v = make_soa(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        double sum = 0;
+        for (const double x : v.field<1>()) {
+            sum += x;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_aos_count_flags(benchmark::State& state) {
+    const my_vector<record> v = make_aos(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        size_t count = 0;
+        for (const record& r : v) {
+            count += (r.flags & 1) != 0;
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_soa_count_flags(benchmark::State& state) {
+    const soa v = make_soa(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        size_t count = 0;
+        for (const uint32_t f : v.field<4>()) {
+            count += (f & 1) != 0;
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// two fields at once: dot product of x and y
+static void BM_aos_dot_xy(benchmark::State& state) {
+    const my_vector<record> v = make_aos(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        double sum = 0;
+        for (const record& r : v) {
+            sum += r.x * r.y;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_soa_dot_xy(benchmark::State& state) {
+    const soa v = make_soa(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        const auto x = v.field<1>();
+        const auto y = v.field<2>();
+        double sum = 0;
+        for (size_t i = 0; i < x.size(); ++i) {
+            sum += x[i] * y[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// appending whole records
+static void BM_aos_push_back(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(make_aos(n).data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_soa_push_back(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(make_soa(n).field<0>().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void sizes(benchmark::internal::Benchmark* b) {
+    for (const int64_t n : {1'000, 100'000, 10'000'000}) {
+        b->Arg(n);
+    }
+    b->Unit(benchmark::kMicrosecond);
+}
+
+BENCHMARK(BM_aos_sum_x)->Apply(sizes);
+BENCHMARK(BM_soa_sum_x)->Apply(sizes);
+BENCHMARK(BM_aos_count_flags)->Apply(sizes);
+BENCHMARK(BM_soa_count_flags)->Apply(sizes);
+BENCHMARK(BM_aos_dot_xy)->Apply(sizes);
+BENCHMARK(BM_soa_dot_xy)->Apply(sizes);
+BENCHMARK(BM_aos_push_back)->Apply(sizes);
+BENCHMARK(BM_soa_push_back)->Apply(sizes);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,99 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include "../my_static_vector.h"
+#include "../my_vector.h"
+
+// a per-request scratch buffer: filled with n values, scanned and dropped
+// each iteration. my_vector pays for a heap allocation per request, the
+// static vectors never allocate; capacity 256 covers every n below.
+
+constexpr size_t scratch_capacity = 256;
+
+template <typename V>
+static void BM_scratch_ints(benchmark::State& state) {
+    const auto n = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        V scratch;
+        for (int i = 0; i < n; ++i) {
+            scratch.push_back(i * 3);
+        }
+        int sum = 0;
+        for (const int x : scratch) {
+            sum += x;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// the same with the my_vector capacity reserved up front, so it allocates
+// exactly once per request
+static void BM_scratch_ints_reserved(benchmark::State& state) {
+    const auto n = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        my_vector<int> scratch;
+        scratch.reserve(scratch_capacity);
+        for (int i = 0; i < n; ++i) {
+            scratch.push_back(i * 3);
+        }
+        int sum = 0;
+        for (const int x : scratch) {
+            sum += x;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// erase-heavy work list: take from the front, insert in the middle
+template <typename V>
+static void BM_scratch_work_list(benchmark::State& state) {
+    const auto n = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        V work;
+        for (int i = 0; i < n; ++i) {
+            work.push_back(i);
+        }
+        int done = 0;
+        while (!work.is_empty()) {
+            const int item = work.front();
+            work.erase(work.begin());
+            if (item % 4 == 0 && item < n) {
+                work.insert(work.begin() + static_cast<std::ptrdiff_t>(work.size() / 2), item + n);
+            }
+            ++done;
+        }
+        benchmark::DoNotOptimize(done);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename V>
+static void BM_scratch_strings(benchmark::State& state) {
+    const auto n = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        V scratch;
+        for (int i = 0; i < n; ++i) {
+            scratch.emplace_back("key");
+        }
+        benchmark::DoNotOptimize(scratch.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void sizes(benchmark::internal::Benchmark* b) {
+    for (const int n : {8, 32, 128, 192}) {
+        b->Arg(n);
+    }
+}
+
+BENCHMARK(BM_scratch_ints<my_vector<int>>)->Apply(sizes);
+BENCHMARK(BM_scratch_ints_reserved)->Apply(sizes);
+BENCHMARK(BM_scratch_ints<my_static_vector<int, scratch_capacity>>)->Apply(sizes);
+BENCHMARK(BM_scratch_ints<my_unchecked_static_vector<int, scratch_capacity>>)->Apply(sizes);
+BENCHMARK(BM_scratch_work_list<my_vector<int>>)->Apply(sizes);
+BENCHMARK(BM_scratch_work_list<my_static_vector<int, scratch_capacity>>)->Apply(sizes);
+BENCHMARK(BM_scratch_strings<my_vector<std::string>>)->Apply(sizes);
+BENCHMARK(BM_scratch_strings<my_static_vector<std::string, scratch_capacity>>)->Apply(sizes);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,330 @@
+#include <benchmark/benchmark.h>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+#include "../my_array.h"
+#include "../my_vector.h"
+
+// Release-to-release benchmark suite for my_vector and my_array, each
+// case paired with the std container. Writes bench_results.json unless
+// --benchmark_out is given, so two runs can be compared with
+// tools/compare.py from Google Benchmark.
+
+struct record64 {
+    int64_t id;
+    double values[7];
+};
+
+template <typename E>
+E make_element (const size_t i) {
+    if constexpr (std::is_same_v<E, std::string>) {
+        return std::to_string(i);
+    } else if constexpr (std::is_same_v<E, record64>) {
+        record64 r{};
+        r.id = static_cast<int64_t>(i);
+        return r;
+    } else {
+        return static_cast<E>(i);
+    }
+}
+
+bool operator==(const record64& a, const record64& b) {
+    return a.id == b.id;
+}
+auto operator<=>(const record64& a, const record64& b) {
+    return a.id <=> b.id;
+}
+
+// the largest sizes do not fit every machine; BENCH_MAX_BYTES caps the
+// footprint of one container (default 2 GiB)
+static size_t max_bytes () {
+    static const size_t limit = [] {
+        const char* env = std::getenv("BENCH_MAX_BYTES");
+        return env != nullptr ? std::strtoull(env, nullptr, 10) : size_t(2) << 30;
+    }();
+    return limit;
+}
+
+template <typename E>
+static bool fits (benchmark::State& state, const size_t copies = 1) {
+    // short strings stay in the SSO buffer, so sizeof(E) is the footprint
+    if (static_cast<size_t>(state.range(0)) * sizeof(E) * copies > max_bytes()) {
+        state.SkipWithError("exceeds BENCH_MAX_BYTES");
+        return false;
+    }
+    return true;
+}
+
+template <typename V>
+static V filled (const size_t n) {
+    V v;
+    v.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        v.push_back(make_element<typename V::value_type>(i));
+    }
+    return v;
+}
+
+template <typename V>
+static void BM_push_back(benchmark::State& state) {
+    using E = typename V::value_type;
+    if (!fits<E>(state, 2)) {
+        return;
+    }
+    const auto n = static_cast<size_t>(state.range(0));
+    const E value = make_element<E>(n);
+    for (auto _ : state) {
+        V v;
+        for (size_t i = 0; i < n; ++i) {
+            v.push_back(value);
+        }
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename V>
+static void BM_emplace_back(benchmark::State& state) {
+    using E = typename V::value_type;
+    if (!fits<E>(state, 2)) {
+        return;
+    }
+    const auto n = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        V v;
+        for (size_t i = 0; i < n; ++i) {
+            v.emplace_back(make_element<E>(i));
+        }
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename V>
+static void BM_reserve_then_fill(benchmark::State& state) {
+    using E = typename V::value_type;
+    if (!fits<E>(state)) {
+        return;
+    }
+    const auto n = static_cast<size_t>(state.range(0));
+    const E value = make_element<E>(1);
+    for (auto _ : state) {
+        V v;
+        v.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            v.push_back(value);
+        }
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// insert one element at front/middle/back and erase it again
+template <typename V>
+static void BM_insert_erase(benchmark::State& state) {
+    using E = typename V::value_type;
+    if (!fits<E>(state)) {
+        return;
+    }
+    const auto n = static_cast<size_t>(state.range(0));
+    const auto where = state.range(1);
+    V v = filled<V>(n);
+    const size_t index = where == 0 ? 0 : where == 1 ? n / 2 : n;
+    const E value = make_element<E>(0);
+    for (auto _ : state) {
+        v.insert(v.begin() + index, value);
+        v.erase(v.begin() + index);
+        benchmark::ClobberMemory();
+    }
+}
+
+template <typename V>
+static void BM_copy(benchmark::State& state) {
+    using E = typename V::value_type;
+    if (!fits<E>(state, 2)) {
+        return;
+    }
+    const V src = filled<V>(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        V copy(src);
+        benchmark::DoNotOptimize(copy.data());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<int64_t>(sizeof(E)));
+}
+
+template <typename V>
+static void BM_move(benchmark::State& state) {
+    using E = typename V::value_type;
+    if (!fits<E>(state)) {
+        return;
+    }
+    V a = filled<V>(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        V b(std::move(a));
+        a = std::move(b);
+        benchmark::DoNotOptimize(a.data());
+    }
+}
+
+template <typename V>
+static void BM_compare(benchmark::State& state) {
+    using E = typename V::value_type;
+    if (!fits<E>(state, 2)) {
+        return;
+    }
+    const auto n = static_cast<size_t>(state.range(0));
+    const V a = filled<V>(n);
+    V b = filled<V>(n);
+    b[n - 1] = make_element<E>(n + 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a == b);
+        benchmark::DoNotOptimize(a < b);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<int64_t>(sizeof(E)) * 2);
+}
+
+template <typename V>
+static void BM_iterate(benchmark::State& state) {
+    using E = typename V::value_type;
+    if (!fits<E>(state)) {
+        return;
+    }
+    const V v = filled<V>(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        size_t acc = 0;
+        for (const E& e : v) {
+            if constexpr (std::is_same_v<E, std::string>) {
+                acc += e.size();
+            } else if constexpr (std::is_same_v<E, record64>) {
+                acc += static_cast<size_t>(e.id);
+            } else {
+                acc += static_cast<size_t>(e);
+            }
+        }
+        benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// fixed-size arrays live on the heap so the large ones do not overflow the stack
+template <typename A>
+static void BM_array_copy(benchmark::State& state) {
+    auto src = std::make_unique<A>();
+    for (size_t i = 0; i < src->size(); ++i) {
+        (*src)[i] = static_cast<int>(i);
+    }
+    auto dst = std::make_unique<A>();
+    for (auto _ : state) {
+        *dst = *src;
+        benchmark::DoNotOptimize(dst->data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(sizeof(A)));
+}
+
+template <typename A>
+static void BM_array_compare(benchmark::State& state) {
+    auto a = std::make_unique<A>();
+    auto b = std::make_unique<A>();
+    for (size_t i = 0; i < a->size(); ++i) {
+        (*a)[i] = (*b)[i] = static_cast<int>(i);
+    }
+    (*b)[b->size() - 1] = -1;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(*a == *b);
+        benchmark::DoNotOptimize(*a < *b);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(sizeof(A)) * 2);
+}
+
+template <typename A>
+static void BM_array_iterate(benchmark::State& state) {
+    auto a = std::make_unique<A>();
+    for (size_t i = 0; i < a->size(); ++i) {
+        (*a)[i] = static_cast<int>(i);
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::accumulate(a->begin(), a->end(), 0LL));
+    }
+}
+
+static void sizes(benchmark::internal::Benchmark* b) {
+    for (const int64_t n : {16, 1'000, 100'000, 10'000'000, 100'000'000}) {
+        b->Arg(n);
+    }
+    b->Unit(benchmark::kMicrosecond);
+}
+
+static void small_sizes(benchmark::internal::Benchmark* b) {
+    for (const int64_t n : {16, 1'000, 100'000}) {
+        b->Arg(n);
+    }
+    b->Unit(benchmark::kMicrosecond);
+}
+
+static void positions(benchmark::internal::Benchmark* b) {
+    for (const int64_t n : {16, 1'000, 100'000}) {
+        for (const int64_t where : {0, 1, 2}) {
+            b->Args({n, where});
+        }
+    }
+}
+
+#define CONTAINER_BENCHMARKS(E)                                            \
+    BENCHMARK(BM_push_back<my_vector<E>>)->Apply(sizes);                   \
+    BENCHMARK(BM_push_back<std::vector<E>>)->Apply(sizes);                 \
+    BENCHMARK(BM_emplace_back<my_vector<E>>)->Apply(sizes);                \
+    BENCHMARK(BM_emplace_back<std::vector<E>>)->Apply(sizes);              \
+    BENCHMARK(BM_reserve_then_fill<my_vector<E>>)->Apply(sizes);           \
+    BENCHMARK(BM_reserve_then_fill<std::vector<E>>)->Apply(sizes);         \
+    BENCHMARK(BM_insert_erase<my_vector<E>>)->Apply(positions);            \
+    BENCHMARK(BM_insert_erase<std::vector<E>>)->Apply(positions);          \
+    BENCHMARK(BM_copy<my_vector<E>>)->Apply(sizes);                        \
+    BENCHMARK(BM_copy<std::vector<E>>)->Apply(sizes);                      \
+    BENCHMARK(BM_move<my_vector<E>>)->Apply(small_sizes);                  \
+    BENCHMARK(BM_move<std::vector<E>>)->Apply(small_sizes);                \
+    BENCHMARK(BM_compare<my_vector<E>>)->Apply(sizes);                     \
+    BENCHMARK(BM_compare<std::vector<E>>)->Apply(sizes);                   \
+    BENCHMARK(BM_iterate<my_vector<E>>)->Apply(sizes);                     \
+    BENCHMARK(BM_iterate<std::vector<E>>)->Apply(sizes);
+
+CONTAINER_BENCHMARKS(int)
+CONTAINER_BENCHMARKS(std::string)
+CONTAINER_BENCHMARKS(record64)
+
+#define ARRAY_BENCHMARKS(N)                                  \
+    BENCHMARK(BM_array_copy<my_array<int, N>>);              \
+    BENCHMARK(BM_array_copy<std::array<int, N>>);            \
+    BENCHMARK(BM_array_compare<my_array<int, N>>);           \
+    BENCHMARK(BM_array_compare<std::array<int, N>>);         \
+    BENCHMARK(BM_array_iterate<my_array<int, N>>);           \
+    BENCHMARK(BM_array_iterate<std::array<int, N>>);
+
+ARRAY_BENCHMARKS(16)
+ARRAY_BENCHMARKS(1024)
+ARRAY_BENCHMARKS(65536)
+
+int main(int argc, char** argv) {
+    std::vector<char*> args(argv, argv + argc);
+    bool has_out = false;
+    for (int i = 1; i < argc; ++i) {
+        has_out = has_out || std::strncmp(argv[i], "--benchmark_out=", 16) == 0;
+    }
+    char out[] = "--benchmark_out=bench_results.json";
+    char format[] = "--benchmark_out_format=json";
+    if (!has_out) {
+        args.push_back(out);
+        args.push_back(format);
+    }
+    int count = static_cast<int>(args.size());
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data())) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
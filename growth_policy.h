@@ -0,0 +1,45 @@
+#ifndef GROWTH_POLICY_H
+#define GROWTH_POLICY_H
+
+#include <cstddef>
+
+// A growth policy decides how many slots my_vector allocates when an
+// append, insert or resize needs more room than the current capacity.
+// next_capacity() must return a value >= required.
+
+[[nodiscard]] constexpr size_t round_up_to (const size_t num, const size_t step) {
+    return (num + step - 1) / step * step;
+}
+
+// doubles the capacity, rounded to 16 elements (the historical behaviour)
+struct growth_factor_2 {
+    [[nodiscard]] static constexpr size_t next_capacity (const size_t capacity, const size_t required, size_t) {
+        const size_t grown = capacity * 2;
+        return round_up_to(grown > required ? grown : required, 16);
+    }
+};
+
+// grows by 1.5x: the sum of all previously freed blocks eventually
+// exceeds the next request, so the allocator can reuse them
+struct growth_factor_1_5 {
+    [[nodiscard]] static constexpr size_t next_capacity (const size_t capacity, const size_t required, size_t) {
+        const size_t grown = capacity + capacity / 2;
+        return round_up_to(grown > required ? grown : required, 16);
+    }
+};
+
+// doubles the capacity, but once the buffer exceeds a page its byte size
+// is rounded to whole pages so no partially used page is requested
+template <size_t PageSize = 4096>
+struct growth_page_aligned {
+    [[nodiscard]] static constexpr size_t next_capacity (const size_t capacity, const size_t required, const size_t elem_size) {
+        const size_t grown = growth_factor_2::next_capacity(capacity, required, elem_size);
+        const size_t bytes = grown * elem_size;
+        if (bytes < PageSize) {
+            return grown;
+        }
+        return round_up_to(bytes, PageSize) / elem_size;
+    }
+};
+
+#endif //GROWTH_POLICY_H
@@ -0,0 +1,146 @@
+#ifndef HUGE_PAGE_ALLOCATOR_H
+#define HUGE_PAGE_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <sys/mman.h>
+
+// Allocator that backs blocks of at least Threshold bytes with 2 MiB pages,
+// so random access into a multi-GB vector needs one TLB entry per 2 MiB
+// instead of one per 4 KiB. Smaller blocks come from the ordinary heap.
+//
+//  - transparent: an anonymous mapping aligned to 2 MiB with
+//    madvise(MADV_HUGEPAGE); the kernel backs it with huge pages when it
+//    can and falls back to 4 KiB pages otherwise.
+//  - hugetlb: MAP_HUGETLB pages from the reserved pool
+//    (/proc/sys/vm/nr_hugepages); when the pool is exhausted the block is
+//    allocated as in transparent mode.
+//
+// expand() lets my_vector grow a mapped block in place with mremap, and
+// reallocate() lets it move one without copying.
+
+enum class huge_page_mode {
+    transparent,
+    hugetlb
+};
+
+inline constexpr size_t huge_page_size = size_t(2) << 20;
+
+template <typename T, size_t Threshold = size_t(32) << 20, huge_page_mode Mode = huge_page_mode::transparent>
+class huge_page_allocator {
+    static_assert(alignof(T) <= huge_page_size, "huge_page_allocator cannot align beyond a huge page");
+
+    [[nodiscard]] static constexpr bool is_mapped (const size_t n) noexcept {
+        return n * sizeof(T) >= Threshold;
+    }
+    [[nodiscard]] static constexpr size_t mapped_bytes (const size_t n) noexcept {
+        return (n * sizeof(T) + huge_page_size - 1) / huge_page_size * huge_page_size;
+    }
+
+    // bytes rounded to whole huge pages, starting on a huge page boundary
+    static void* map_transparent (const size_t bytes) {
+        // over-map by one huge page and trim both ends to the boundary
+        const size_t padded = bytes + huge_page_size;
+        void* raw = ::mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        const auto begin = reinterpret_cast<uintptr_t>(raw);
+        const uintptr_t aligned = (begin + huge_page_size - 1) & ~(huge_page_size - 1);
+        if (aligned != begin) {
+            ::munmap(raw, aligned - begin);
+        }
+        const size_t tail = begin + padded - (aligned + bytes);
+        if (tail != 0) {
+            ::munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+        }
+        void* p = reinterpret_cast<void*>(aligned);
+        ::madvise(p, bytes, MADV_HUGEPAGE);
+        return p;
+    }
+    static void* map (const size_t bytes) {
+        if constexpr (Mode == huge_page_mode::hugetlb) {
+            void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (21 << MAP_HUGE_SHIFT), -1, 0);
+            if (p != MAP_FAILED) {
+                return p;
+            }
+        }
+        return map_transparent(bytes);
+    }
+
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = huge_page_allocator<U, Threshold, Mode>;
+    };
+
+    huge_page_allocator () noexcept = default;
+    template <typename U>
+    explicit huge_page_allocator (const huge_page_allocator<U, Threshold, Mode>&) noexcept {}
+
+    [[nodiscard]] T* allocate (const size_t n) {
+        if (!is_mapped(n)) {
+            return std::allocator<T>().allocate(n);
+        }
+        return static_cast<T*>(map(mapped_bytes(n)));
+    }
+    void deallocate (T* p, const size_t n) noexcept {
+        if (!is_mapped(n)) {
+            std::allocator<T>().deallocate(p, n);
+            return;
+        }
+        ::munmap(p, mapped_bytes(n));
+    }
+
+    // grows a block of old_n slots to new_n slots without moving it; false
+    // when the block is on the heap or the address range after it is taken
+    [[nodiscard]] bool expand (T* p, const size_t old_n, const size_t new_n) noexcept {
+        if (!is_mapped(old_n)) {
+            return false;
+        }
+        const size_t old_bytes = mapped_bytes(old_n);
+        const size_t new_bytes = mapped_bytes(new_n);
+        if (new_bytes == old_bytes) {
+            return true;
+        }
+        if (::mremap(p, old_bytes, new_bytes, 0) == MAP_FAILED) {
+            return false;
+        }
+        // a hugetlb mapping stays hugetlb, an advised one needs the new tail advised
+        ::madvise(reinterpret_cast<char*>(p) + old_bytes, new_bytes - old_bytes, MADV_HUGEPAGE);
+        return true;
+    }
+
+    // moves a mapped block to new_n slots with mremap, which remaps the
+    // pages instead of copying them; nullptr when either block is on the
+    // heap, and my_vector then copies as usual
+    [[nodiscard]] T* reallocate (T* p, const size_t old_n, const size_t new_n) noexcept {
+        if (!is_mapped(old_n) || !is_mapped(new_n)) {
+            return nullptr;
+        }
+        const size_t old_bytes = mapped_bytes(old_n);
+        const size_t new_bytes = mapped_bytes(new_n);
+        void* moved = ::mremap(p, old_bytes, new_bytes, MREMAP_MAYMOVE);
+        if (moved == MAP_FAILED) {
+            return nullptr;
+        }
+        if (new_bytes > old_bytes) {
+            ::madvise(static_cast<char*>(moved) + old_bytes, new_bytes - old_bytes, MADV_HUGEPAGE);
+        }
+        return static_cast<T*>(moved);
+    }
+
+    template <typename U>
+    friend bool operator==(const huge_page_allocator&, const huge_page_allocator<U, Threshold, Mode>&) noexcept {
+        return true;
+    }
+};
+
+#endif //HUGE_PAGE_ALLOCATOR_H
@@ -0,0 +1,54 @@
+#ifndef MALLOC_ALLOCATOR_H
+#define MALLOC_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+
+// Allocator over malloc/free whose reallocate() hook lets my_vector grow
+// trivially relocatable elements with realloc instead of allocate + copy +
+// free. glibc extends the block in place when the heap allows and moves
+// mmap-backed blocks (the large ones) with mremap, so neither path copies
+// the data or holds the old and new block at the same time.
+template <typename T>
+class malloc_allocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc does not provide over-aligned storage");
+
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = malloc_allocator<U>;
+    };
+
+    malloc_allocator () noexcept = default;
+    template <typename U>
+    explicit malloc_allocator (const malloc_allocator<U>&) noexcept {}
+
+    [[nodiscard]] T* allocate (const size_t n) {
+        void* p = std::malloc(n * sizeof(T));
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(p);
+    }
+    void deallocate (T* p, size_t) noexcept {
+        std::free(p);
+    }
+
+    // moves the bytes of a block of old_n slots into one of new_n slots,
+    // possibly at a new address; nullptr leaves the old block untouched
+    [[nodiscard]] T* reallocate (T* p, size_t, const size_t new_n) noexcept {
+        return static_cast<T*>(std::realloc(p, new_n * sizeof(T)));
+    }
+
+    template <typename U>
+    friend bool operator==(const malloc_allocator&, const malloc_allocator<U>&) noexcept {
+        return true;
+    }
+};
+
+#endif //MALLOC_ALLOCATOR_H
@@ -0,0 +1,227 @@
+#ifndef MY_ALLOCATORS_H
+#define MY_ALLOCATORS_H
+
+#include <bit>
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+
+// Memory resources for short-lived my_vector instances. Both derive from
+// std::pmr::memory_resource, so they work with pmr::my_vector as well as
+// with the non-virtual resource_allocator below.
+
+// Monotonic bump allocator: deallocation is a no-op and everything is
+// returned at once by release() or the destructor. Meant for one arena
+// per request, with every vector built during the request living in it.
+class arena_resource final : public std::pmr::memory_resource {
+    struct block {
+        block* next;
+        size_t size;
+    };
+
+    block* blocks_m = nullptr;
+    char* cur_m = nullptr;
+    char* end_m = nullptr;
+    size_t next_block_size_m;
+
+    void add_block (const size_t min_bytes) {
+        size_t size = next_block_size_m;
+        while (size < min_bytes + sizeof(block)) {
+            size *= 2;
+        }
+        auto* b = static_cast<block*>(::operator new(size));
+        b->next = blocks_m;
+        b->size = size;
+        blocks_m = b;
+        cur_m = reinterpret_cast<char*>(b + 1);
+        end_m = reinterpret_cast<char*>(b) + size;
+        next_block_size_m = size * 2;
+    }
+
+protected:
+    void* do_allocate (const size_t bytes, const size_t alignment) override {
+        return allocate_bytes(bytes, alignment);
+    }
+    void do_deallocate (void*, size_t, size_t) override {}
+    [[nodiscard]] bool do_is_equal (const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+public:
+    explicit arena_resource (const size_t initial_block_size = 64 * 1024) : next_block_size_m (initial_block_size) {}
+    arena_resource (const arena_resource&) = delete;
+    arena_resource& operator=(const arena_resource&) = delete;
+    ~arena_resource() override {
+        release();
+    }
+
+    [[nodiscard]] void* allocate_bytes (const size_t bytes, const size_t alignment) {
+        auto space = static_cast<size_t>(end_m - cur_m);
+        void* p = cur_m;
+        if (cur_m == nullptr || std::align(alignment, bytes, p, space) == nullptr) {
+            add_block(bytes + alignment);
+            space = static_cast<size_t>(end_m - cur_m);
+            p = cur_m;
+            std::align(alignment, bytes, p, space);
+        }
+        cur_m = static_cast<char*>(p) + bytes;
+        return p;
+    }
+    void deallocate_bytes (void*, size_t, size_t) noexcept {}
+
+    // grows the most recent allocation when the current block has room
+    [[nodiscard]] bool expand_bytes (void* p, const size_t old_bytes, const size_t new_bytes, size_t) noexcept {
+        char* const first = static_cast<char*>(p);
+        if (first + old_bytes != cur_m || new_bytes > static_cast<size_t>(end_m - first)) {
+            return false;
+        }
+        cur_m = first + new_bytes;
+        return true;
+    }
+
+    // frees every block; all vectors built in the arena must be gone
+    void release () noexcept {
+        while (blocks_m != nullptr) {
+            block* next = blocks_m->next;
+            ::operator delete(blocks_m);
+            blocks_m = next;
+        }
+        cur_m = nullptr;
+        end_m = nullptr;
+    }
+};
+
+// Free-list pool with power-of-two size classes from 64 bytes to 1 MiB.
+// my_vector capacities are multiples of 16 elements that double on
+// growth, so for power-of-two element sizes every buffer fills its class
+// exactly and a freed buffer is reused by the next vector of that size.
+class pool_resource final : public std::pmr::memory_resource {
+    static constexpr size_t min_class_shift = 6;
+    static constexpr size_t class_count = 15;
+    static constexpr size_t max_pooled = size_t(1) << (min_class_shift + class_count - 1);
+    static constexpr size_t block_alignment = 64;
+
+    struct free_node {
+        free_node* next;
+    };
+
+    free_node* free_lists_m[class_count] = {};
+
+    [[nodiscard]] static size_t class_of (const size_t bytes) {
+        const size_t rounded = std::bit_ceil(bytes < 64 ? size_t(64) : bytes);
+        return static_cast<size_t>(std::countr_zero(rounded)) - min_class_shift;
+    }
+    [[nodiscard]] static bool pooled (const size_t bytes, const size_t alignment) {
+        return bytes <= max_pooled && alignment <= block_alignment;
+    }
+
+protected:
+    void* do_allocate (const size_t bytes, const size_t alignment) override {
+        return allocate_bytes(bytes, alignment);
+    }
+    void do_deallocate (void* p, const size_t bytes, const size_t alignment) override {
+        deallocate_bytes(p, bytes, alignment);
+    }
+    [[nodiscard]] bool do_is_equal (const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+public:
+    pool_resource () = default;
+    pool_resource (const pool_resource&) = delete;
+    pool_resource& operator=(const pool_resource&) = delete;
+    ~pool_resource() override {
+        release();
+    }
+
+    [[nodiscard]] void* allocate_bytes (const size_t bytes, const size_t alignment) {
+        if (!pooled(bytes, alignment)) {
+            return ::operator new(bytes, std::align_val_t(alignment));
+        }
+        const size_t cls = class_of(bytes);
+        if (free_node* node = free_lists_m[cls]) {
+            free_lists_m[cls] = node->next;
+            return node;
+        }
+        return ::operator new(size_t(1) << (cls + min_class_shift), std::align_val_t(block_alignment));
+    }
+    void deallocate_bytes (void* p, const size_t bytes, const size_t alignment) noexcept {
+        if (!pooled(bytes, alignment)) {
+            ::operator delete(p, std::align_val_t(alignment));
+            return;
+        }
+        const size_t cls = class_of(bytes);
+        free_lists_m[cls] = ::new (p) free_node{free_lists_m[cls]};
+    }
+
+    // a pooled block can grow up to the size of its class
+    [[nodiscard]] static bool expand_bytes (void*, const size_t old_bytes, const size_t new_bytes, const size_t alignment) noexcept {
+        return pooled(new_bytes, alignment) && class_of(old_bytes) == class_of(new_bytes);
+    }
+
+    // returns cached free blocks to the global heap
+    void release () noexcept {
+        for (auto& head : free_lists_m) {
+            while (head != nullptr) {
+                free_node* next = head->next;
+                ::operator delete(head, std::align_val_t(block_alignment));
+                head = next;
+            }
+        }
+    }
+};
+
+// Allocator calling a concrete resource directly, without the virtual
+// dispatch of std::pmr::polymorphic_allocator. Not propagated on copy,
+// so a copied vector stays in the arena or pool it was built in.
+template <typename T, typename Resource>
+class resource_allocator {
+    template <typename U, typename R>
+    friend class resource_allocator;
+
+    Resource* resource_m;
+
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    template <typename U>
+    struct rebind {
+        using other = resource_allocator<U, Resource>;
+    };
+
+    explicit resource_allocator (Resource& resource) noexcept : resource_m (&resource) {}
+    template <typename U>
+    resource_allocator (const resource_allocator<U, Resource>& other) noexcept : resource_m (other.resource_m) {}
+
+    [[nodiscard]] T* allocate (const size_t n) {
+        return static_cast<T*>(resource_m->allocate_bytes(n * sizeof(T), alignof(T)));
+    }
+    void deallocate (T* p, const size_t n) noexcept {
+        resource_m->deallocate_bytes(p, n * sizeof(T), alignof(T));
+    }
+    // in-place growth hook used by my_vector
+    [[nodiscard]] bool expand (T* p, const size_t old_n, const size_t new_n) noexcept {
+        return resource_m->expand_bytes(p, old_n * sizeof(T), new_n * sizeof(T), alignof(T));
+    }
+
+    [[nodiscard]] Resource* resource () const noexcept {
+        return resource_m;
+    }
+
+    template <typename U>
+    friend bool operator==(const resource_allocator& a, const resource_allocator<U, Resource>& b) {
+        return a.resource_m == b.resource_m;
+    }
+};
+
+template <typename T>
+using arena_allocator = resource_allocator<T, arena_resource>;
+
+template <typename T>
+using pool_allocator = resource_allocator<T, pool_resource>;
+
+#endif //MY_ALLOCATORS_H
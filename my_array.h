@@ -1,25 +1,64 @@
 #ifndef MY_ARRAY_H
 #define MY_ARRAY_H
 
+#include <algorithm>
+#include <compare>
+#include <initializer_list>
 #include <iterator>
-
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "relocation.h"
+#include "simd_compare.h"
+#include "simd_fill.h"
+
+// arrays of up to this many elements have their element-wise operations
+// expanded into straight-line code instead of a loop over N
+inline constexpr size_t my_array_unroll_limit = 16;
+
+// Every member is constexpr, so lookup tables and fixed-size keys can be
+// built at compile time. During constant evaluation the operations use
+// plain element loops; at run time small arrays use the unrolled forms and
+// larger ones the memmove/SIMD helpers.
 template <typename T, std::size_t N>
 class my_array {
     T data_m[N];
 
-public:
-    // constructors
-    my_array () {
-        for (size_t i = 0; i < N; i++) {
-            data_m[i] = T();
+    static constexpr bool unrolled = N <= my_array_unroll_limit;
+
+    // f(0), f(1), ..., f(N - 1), as a fold over an index_sequence for small N
+    template <typename F>
+    static constexpr void for_each_index (F&& f) {
+        if constexpr (unrolled) {
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                (f(I), ...);
+            }(std::make_index_sequence<N>());
+        } else {
+            for (size_t i = 0; i < N; ++i) {
+                f(i);
+            }
         }
     }
-    explicit my_array (const T& value) {
-        for (size_t i = 0; i < N; i++) {
-            data_m[i] = value;
+    // move_elements() is memmove based, which is not a constant expression
+    static constexpr void shift (T* first, T* last, T* dest) {
+        if (std::is_constant_evaluated()) {
+            if (dest < first) {
+                std::move(first, last, dest);
+            } else {
+                std::move_backward(first, last, dest + (last - first));
+            }
+        } else {
+            move_elements(first, last, dest);
         }
     }
-    my_array(std::initializer_list<T> init) {
+
+public:
+    // constructors
+    constexpr my_array () : data_m{} {}
+    constexpr explicit my_array (const T& value) {
+        fill(value);
+    }
+    constexpr my_array(std::initializer_list<T> init) {
         size_t i = 0;
         for (auto& value : init) {
             if (i < N) {
@@ -31,7 +70,7 @@ public:
         }
     }
     template<typename InputIt, typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
-    my_array (InputIt first, InputIt last) {
+    constexpr my_array (InputIt first, InputIt last) {
         size_t i = 0;
         for (InputIt it = first; it != last && i < N; ++it, ++i) {
             data_m[i] = *it;
@@ -41,57 +80,31 @@ public:
         }
     }
 
-    // copy
-    my_array (const my_array& other) {
-        for (size_t i = 0; i < N; i++) {
-            data_m[i] = other.data_m[i];
-        }
-    }
-    my_array& operator=(const my_array& other) {
-        if (this != &other) {
-            for (size_t i = 0; i < N; i++) {
-                data_m[i] = other.data_m[i];
-            }
-        }
-        return *this;
-    }
-
-    // move
-    my_array (my_array&& other)  noexcept {
-        for (size_t i = 0; i < N; i++) {
-            data_m[i] = other.data_m[i];
-        }
-        other.clear();
-    }
-    my_array& operator=(my_array&& other) noexcept {
-        if (this != &other) {
-            for (size_t i = 0; i < N; i++) {
-                data_m[i] = other.data_m[i];
-            }
-            other.clear();
-        }
-        return *this;
-    }
-
-    // destructor
-    ~my_array() = default;
+    // copy and move are the implicit element-wise ones, so an array of a
+    // trivially copyable T is itself trivially copyable (memcpy-able and
+    // passed in registers), and a moved-from array holds moved-from elements
+    constexpr my_array (const my_array& other) = default;
+    constexpr my_array& operator=(const my_array& other) = default;
+    constexpr my_array (my_array&& other) = default;
+    constexpr my_array& operator=(my_array&& other) = default;
+    constexpr ~my_array() = default;
 
     // access operators
-    T& operator[](size_t index) {
+    constexpr T& operator[](size_t index) {
         return data_m[index];
     }
-    const T& operator[](size_t index) const {
+    constexpr const T& operator[](size_t index) const {
         return data_m[index];
     }
 
-    T& at(size_t index) {
+    constexpr T& at(size_t index) {
         if (index >= N) {
             throw std::out_of_range("Index out of range in at()");
         }
 
         return data_m[index];
     }
-    const T& at(size_t index) const {
+    constexpr const T& at(size_t index) const {
         if (index >= N) {
             throw std::out_of_range("Index out of range in at()");
         }
@@ -99,28 +112,28 @@ public:
         return data_m[index];
     }
 
-    T& back() {
+    constexpr T& back() {
         if (N == 0) {
             throw std::out_of_range("Accessing empty vector in back()");
         }
 
         return data_m[N - 1];
     }
-    const T& back() const {
+    constexpr const T& back() const {
         if (N == 0) {
             throw std::out_of_range("Accessing empty vector in back()");
         }
 
         return data_m[N - 1];
     }
-    T& front() {
+    constexpr T& front() {
         if (N == 0) {
             throw std::out_of_range("Accessing empty vector in front()");
         }
 
         return data_m[0];
     }
-    const T& front() const {
+    constexpr const T& front() const {
         if (N == 0) {
             throw std::out_of_range("Accessing empty vector in front()");
         }
@@ -129,94 +142,100 @@ public:
     }
 
     // iterators
-    T* begin() {
+    constexpr T* begin() {
         return data_m;
     }
-    T* end() {
+    constexpr T* end() {
         return data_m + N;
     }
 
-    const T* begin() const {
+    constexpr const T* begin() const {
         return data_m;
     }
-    const T* end() const {
+    constexpr const T* end() const {
         return data_m + N;
     }
 
-    const T* cbegin() const {
+    constexpr const T* cbegin() const {
         return data_m;
     }
-    const T* cend() const {
+    constexpr const T* cend() const {
         return data_m + N;
     }
 
-    std::reverse_iterator<T*> rbegin() {
+    constexpr std::reverse_iterator<T*> rbegin() {
         return std::reverse_iterator<T*>(end());
     }
-    std::reverse_iterator<T*> rend() {
+    constexpr std::reverse_iterator<T*> rend() {
         return std::reverse_iterator<T*>(begin());
     }
 
-    std::reverse_iterator<const T*> rcbegin() const {
+    constexpr std::reverse_iterator<const T*> rcbegin() const {
         return std::reverse_iterator<const T*>(cend());
     }
-    std::reverse_iterator<const T*> rcend() const {
+    constexpr std::reverse_iterator<const T*> rcend() const {
         return std::reverse_iterator<const T*>(cbegin());
     }
 
     // additional methods
-    [[nodiscard]] bool is_empty() const {
+    [[nodiscard]] constexpr bool is_empty() const {
         return N == 0;
     }
-    [[nodiscard]] size_t size() const {
+    [[nodiscard]] constexpr size_t size() const {
         return N;
     }
-    T* data() {
+    constexpr T* data() {
+        return data_m;
+    }
+    constexpr const T* data() const {
         return data_m;
     }
 
     // swap
-    void swap (my_array& other) noexcept {
-        std::swap (data_m, other.data_m);
+    constexpr void swap (my_array& other) noexcept(std::is_nothrow_swappable_v<T>) {
+        if constexpr (unrolled) {
+            for_each_index([&](const size_t i) {
+                using std::swap;
+                swap(data_m[i], other.data_m[i]);
+            });
+        } else {
+            std::swap_ranges(data_m, data_m + N, other.data_m);
+        }
     }
 
     // clear, resize
-    void clear () {
-        for (size_t i = 0; i < N; i++) {
-            data_m[i] = T();
-        }
-    }
-    void fill(const T& value) {
-        for (size_t i = 0; i < N; i++) {
-            data_m[i] = value;
+    constexpr void clear () {
+        fill(T());
+    }
+    constexpr void fill(const T& value) {
+        if (std::is_constant_evaluated() || unrolled) {
+            for_each_index([&](const size_t i) { data_m[i] = value; });
+        } else {
+            fill_elements(data_m, N, value);
         }
     }
 
     // inserts
-    T* insert(T* it, const T& value) {
+    constexpr T* insert(T* it, const T& value) {
         size_t index = it - data_m;
 
         if (index >= N) return nullptr;
 
-        for (size_t i = N - 1; i > index; --i) {
-            data_m[i] = std::move(data_m[i - 1]);
-        }
-
-        data_m[index] = value;
+        T copy = value;
+        shift(data_m + index, data_m + N - 1, data_m + index + 1);
+        data_m[index] = std::move(copy);
         return data_m + index;
     }
 
     template<typename InputIt>
-    T* insert(T* it, InputIt first, InputIt last) {
+    constexpr T* insert(T* it, InputIt first, InputIt last) {
         size_t index = it - data_m;
         const size_t count = std::distance(first, last);
-        const size_t limit = std::min(N - index, count);
 
         if (index >= N) return nullptr;
 
-        for (size_t i = N - 1; i >= index + limit; --i) {
-            data_m[i] = std::move(data_m[i - limit]);
-        }
+        const size_t limit = std::min(N - index, count);
+        shift(data_m + index, data_m + N - limit, data_m + index + limit);
 
         for (size_t i = 0; i < limit; ++i) {
             data_m[index + i] = *(first + i);
@@ -226,53 +245,59 @@ public:
     }
 
     // erase
-    T* erase(T* pos) {
+    constexpr T* erase(T* pos) {
         size_t index = pos - data_m;
 
         if (index >= N) return nullptr;
 
-        for (size_t i = index; i < N - 1; ++i) {
-            data_m[i] = std::move(data_m[i + 1]);
-        }
+        shift(data_m + index + 1, data_m + N, data_m + index);
 
         return data_m + index;
     }
-    T* erase(T* first, T* last) {
+    constexpr T* erase(T* first, T* last) {
         size_t start = first - data_m;
         size_t end = last - data_m;
-        size_t count = end - start;
 
         if (start >= N || end > N) return nullptr;
 
-        for (size_t i = start; i < N - count; ++i) {
-            data_m[i] = std::move(data_m[i + count]);
-        }
+        shift(data_m + end, data_m + N, data_m + start);
 
         return data_m + start;
     }
 
-    friend bool operator==(const my_array& a, const my_array& b) {
-        return std::equal(a.begin(), a.end(), b.begin());
+    friend constexpr bool operator==(const my_array& a, const my_array& b) {
+        if constexpr (unrolled) {
+            return [&]<size_t... I>(std::index_sequence<I...>) {
+                return ((a.data_m[I] == b.data_m[I]) && ...);
+            }(std::make_index_sequence<N>());
+        } else {
+            if (std::is_constant_evaluated()) {
+                return std::equal(a.data_m, a.data_m + N, b.data_m);
+            }
+            return elements_equal(a.data_m, b.data_m, N);
+        }
     }
 
-    friend bool operator!=(const my_array& a, const my_array& b) {
+    friend constexpr bool operator!=(const my_array& a, const my_array& b) {
         return !(a == b);
     }
 
-    friend bool operator<(const my_array& a, const my_array& b) {
-        return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
-    }
-
-    friend bool operator>(const my_array& a, const my_array& b) {
-        return b < a;
-    }
-
-    friend bool operator<=(const my_array& a, const my_array& b) {
-        return !(b < a);
-    }
-
-    friend bool operator>=(const my_array& a, const my_array& b) {
-        return !(a < b);
+    // <, >, <= and >= are rewritten in terms of <=>, one pass per comparison
+    friend constexpr auto operator<=>(const my_array& a, const my_array& b) {
+        if constexpr (unrolled) {
+            // the first element pair that is not equivalent decides
+            synth_three_way_result<T> result = std::strong_ordering::equal;
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                (((result = synth_three_way()(a.data_m[I], b.data_m[I])) == 0) && ...);
+            }(std::make_index_sequence<N>());
+            return result;
+        } else {
+            if (std::is_constant_evaluated()) {
+                return std::lexicographical_compare_three_way(a.data_m, a.data_m + N, b.data_m, b.data_m + N,
+                                                              synth_three_way());
+            }
+            return elements_compare(a.data_m, N, b.data_m, N);
+        }
     }
 
 };
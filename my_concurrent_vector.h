@@ -0,0 +1,241 @@
+#ifndef MY_CONCURRENT_VECTOR_H
+#define MY_CONCURRENT_VECTOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include "my_vector.h"
+
+// Append-only vector that many threads may push_back/emplace_back into at
+// once without locks. Elements live in segments of doubling size that are
+// never reallocated, so growing never moves an element and references stay
+// valid for the lifetime of the container.
+//
+// An append claims an index with one fetch_add, installs the segment with a
+// compare-exchange if it is the first to reach it, constructs the element
+// and then marks its slot as ready. No append ever waits for another: the
+// append that reaches the middle of segment k installs segment k + 1 ahead
+// of time, so racing allocations of one segment are rare and the losers
+// just free their copy.
+//
+// Reads of an element are safe once the push that wrote it has returned
+// and that return happens-before the read (e.g. through a thread join);
+// snapshot() may run concurrently with pushes and copies the elements that
+// are ready at that moment.
+template <typename T>
+class my_concurrent_vector {
+    // slot states
+    static constexpr unsigned char empty = 0;
+    static constexpr unsigned char ready = 1;
+    static constexpr unsigned char failed = 2; // the constructor threw
+
+    // segment k holds first_segment << k elements, about 1 KiB in segment 0
+    static constexpr size_t first_segment = std::bit_ceil(std::max<size_t>(1, 1024 / sizeof(T)));
+    static constexpr size_t max_segments = 64;
+
+    struct segment {
+        T* items;
+        std::atomic<unsigned char>* states;
+        size_t length;
+    };
+
+    std::atomic<segment*> segments_m[max_segments] {};
+    std::atomic<size_t> size_m {0};
+
+    [[nodiscard]] static size_t segment_of (const size_t index) noexcept {
+        return static_cast<size_t>(std::bit_width(index / first_segment + 1)) - 1;
+    }
+    [[nodiscard]] static size_t segment_base (const size_t k) noexcept {
+        return first_segment * ((size_t(1) << k) - 1);
+    }
+
+    static segment* make_segment (const size_t k) {
+        const size_t length = first_segment << k;
+        auto states = std::make_unique<std::atomic<unsigned char>[]>(length);
+        T* items = std::allocator<T>().allocate(length);
+        segment* s;
+        try {
+            s = new segment {items, states.get(), length};
+        } catch (...) {
+            std::allocator<T>().deallocate(items, length);
+            throw;
+        }
+        states.release();
+        return s;
+    }
+    static void free_segment (segment* s) noexcept {
+        std::allocator<T>().deallocate(s->items, s->length);
+        delete[] s->states;
+        delete s;
+    }
+
+    // the segment for segment index k, installing it if this thread gets
+    // there first; a thread that loses the race frees its own copy
+    segment* acquire_segment (const size_t k) {
+        segment* s = segments_m[k].load(std::memory_order_acquire);
+        if (s != nullptr) {
+            return s;
+        }
+        segment* fresh = make_segment(k);
+        if (segments_m[k].compare_exchange_strong(s, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return fresh;
+        }
+        free_segment(fresh);
+        return s;
+    }
+
+    // called by the one append that claims the middle slot of segment k:
+    // installs segment k + 1 while the appends still land in k, so the
+    // threads that reach k + 1 find it ready instead of all allocating it
+    void prepare_next_segment (const size_t k) noexcept {
+        if (k + 1 < max_segments && segments_m[k + 1].load(std::memory_order_relaxed) == nullptr) {
+            try {
+                acquire_segment(k + 1);
+            } catch (...) {
+                // only an optimization: the first append into k + 1 retries
+            }
+        }
+    }
+
+    [[nodiscard]] segment* segment_at (const size_t k) const noexcept {
+        return segments_m[k].load(std::memory_order_acquire);
+    }
+
+    // calls f(items, states, count) for every segment that holds claimed slots
+    template <typename F>
+    void for_each_segment (const size_t n, F&& f) const {
+        for (size_t k = 0; k < max_segments && segment_base(k) < n; ++k) {
+            segment* s = segment_at(k);
+            if (s == nullptr) {
+                continue; // the thread that claimed the slots has not installed it yet
+            }
+            f(s->items, s->states, std::min(s->length, n - segment_base(k)));
+        }
+    }
+
+    void destroy_all () noexcept {
+        const size_t n = size_m.load(std::memory_order_acquire);
+        for (size_t k = 0; k < max_segments; ++k) {
+            segment* s = segments_m[k].load(std::memory_order_acquire);
+            if (s == nullptr) {
+                continue;
+            }
+            const size_t count = segment_base(k) < n ? std::min(s->length, n - segment_base(k)) : 0;
+            for (size_t i = 0; i < count; ++i) {
+                if (s->states[i].load(std::memory_order_acquire) == ready) {
+                    std::destroy_at(s->items + i);
+                }
+            }
+            free_segment(s);
+            segments_m[k].store(nullptr, std::memory_order_relaxed);
+        }
+        size_m.store(0, std::memory_order_relaxed);
+    }
+
+public:
+    using value_type = T;
+
+    my_concurrent_vector () = default;
+    my_concurrent_vector (const my_concurrent_vector&) = delete;
+    my_concurrent_vector& operator=(const my_concurrent_vector&) = delete;
+    ~my_concurrent_vector() {
+        destroy_all();
+    }
+
+    // thread-safe appends
+    template <typename... Args>
+    T& emplace_back (Args&&... args) {
+        const size_t index = size_m.fetch_add(1, std::memory_order_relaxed);
+        const size_t k = segment_of(index);
+        segment* s = acquire_segment(k);
+        const size_t offset = index - segment_base(k);
+        try {
+            std::construct_at(s->items + offset, std::forward<Args>(args)...);
+        } catch (...) {
+            // the slot stays claimed, but is skipped by readers and the destructor
+            s->states[offset].store(failed, std::memory_order_release);
+            throw;
+        }
+        s->states[offset].store(ready, std::memory_order_release);
+        if (offset == s->length / 2) {
+            prepare_next_segment(k);
+        }
+        return s->items[offset];
+    }
+    T& push_back (const T& value) {
+        return emplace_back(value);
+    }
+    T& push_back (T&& value) {
+        return emplace_back(std::move(value));
+    }
+
+    // element access; see the note above on when an element may be read
+    T& operator[](const size_t index) {
+        const size_t k = segment_of(index);
+        return segment_at(k)->items[index - segment_base(k)];
+    }
+    const T& operator[](const size_t index) const {
+        const size_t k = segment_of(index);
+        return segment_at(k)->items[index - segment_base(k)];
+    }
+
+    // throws unless the element exists and its constructor has finished
+    const T& at (const size_t index) const {
+        if (index >= size()) {
+            throw std::out_of_range("Index out of range in at()");
+        }
+        const size_t k = segment_of(index);
+        const segment* s = segment_at(k);
+        const size_t offset = index - segment_base(k);
+        if (s == nullptr || s->states[offset].load(std::memory_order_acquire) != ready) {
+            throw std::out_of_range("Element is not constructed yet in at()");
+        }
+        return s->items[offset];
+    }
+    T& at (const size_t index) {
+        return const_cast<T&>(std::as_const(*this).at(index));
+    }
+
+    // number of claimed slots, including elements still being constructed
+    [[nodiscard]] size_t size () const {
+        return size_m.load(std::memory_order_acquire);
+    }
+    [[nodiscard]] bool is_empty () const {
+        return size() == 0;
+    }
+
+    // contiguous copy of the ready elements in index order. Whole runs of
+    // ready slots are copied at once, which is a memcpy for trivially
+    // copyable types.
+    template <typename Growth = growth_factor_2>
+    my_vector<T, Growth> snapshot () const {
+        my_vector<T, Growth> result;
+        const size_t n = size();
+        result.reserve(n);
+        for_each_segment(n, [&](const T* items, const std::atomic<unsigned char>* states, const size_t count) {
+            size_t i = 0;
+            while (i < count) {
+                while (i < count && states[i].load(std::memory_order_acquire) != ready) {
+                    ++i;
+                }
+                const size_t run = i;
+                while (i < count && states[i].load(std::memory_order_acquire) == ready) {
+                    ++i;
+                }
+                result.insert(result.end(), items + run, items + i);
+            }
+        });
+        return result;
+    }
+
+    // not thread-safe: no other thread may use the container meanwhile
+    void clear () {
+        destroy_all();
+    }
+};
+
+#endif //MY_CONCURRENT_VECTOR_H
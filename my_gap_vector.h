@@ -0,0 +1,529 @@
+#ifndef MY_GAP_VECTOR_H
+#define MY_GAP_VECTOR_H
+
+#include <algorithm>
+#include <compare>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "growth_policy.h"
+#include "my_span.h"
+#include "relocation.h"
+#include "simd_compare.h"
+
+// Vector with a movable gap of unconstructed slots inside its buffer, for
+// editing workloads that insert and erase around a cursor. The elements
+// are [0, gap_begin) and [gap_end, capacity); an insert or erase at the
+// gap is O(1), and moving the gap to a new position costs the distance
+// moved, so edits that stay near each other are amortized O(1) instead of
+// shifting the whole tail as my_vector::insert does.
+//
+// Elements are addressed by index. operator[] is one compare away from
+// a plain array access; contiguous() closes the gap and returns a
+// my_span over the compacted buffer without copying.
+template <typename T, typename Growth = growth_factor_2>
+class my_gap_vector {
+    T* data_m = nullptr;
+    size_t capacity_m = 0;
+    size_t gap_begin_m = 0;
+    size_t gap_end_m = 0;
+
+    [[nodiscard]] size_t gap_size () const noexcept {
+        return gap_end_m - gap_begin_m;
+    }
+    // buffer slot holding the element at index
+    [[nodiscard]] size_t slot (const size_t index) const noexcept {
+        return index < gap_begin_m ? index : index + gap_size();
+    }
+
+    [[nodiscard]] static T* allocate (const size_t n) {
+        return n == 0 ? nullptr : std::allocator<T>().allocate(n);
+    }
+    static void deallocate (T* p, const size_t n) noexcept {
+        if (p != nullptr) {
+            std::allocator<T>().deallocate(p, n);
+        }
+    }
+    void destroy_all () noexcept {
+        std::destroy(data_m, data_m + gap_begin_m);
+        std::destroy(data_m + gap_end_m, data_m + capacity_m);
+        deallocate(data_m, capacity_m);
+    }
+
+    // see my_vector::transfer
+    static void transfer (T* src, const size_t n, T* dst) {
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            std::uninitialized_move_n(src, n, dst);
+        } else {
+            std::uninitialized_copy_n(src, n, dst);
+        }
+    }
+
+    // moves one element from src to the unconstructed slot dst
+    static void relocate_one (T* src, T* dst) {
+        std::construct_at(dst, std::move(*src));
+        std::destroy_at(src);
+    }
+
+    // moves the gap so that it starts at index
+    void move_gap (const size_t index) {
+        if (index == gap_begin_m || gap_size() == 0) {
+            gap_end_m += index - gap_begin_m;
+            gap_begin_m = index;
+            return;
+        }
+        if constexpr (is_trivially_relocatable_v<T>) {
+            if (index < gap_begin_m) {
+                const size_t n = gap_begin_m - index;
+                std::memmove(static_cast<void*>(data_m + gap_end_m - n), static_cast<const void*>(data_m + index),
+                             n * sizeof(T));
+                gap_begin_m -= n;
+                gap_end_m -= n;
+            } else {
+                const size_t n = index - gap_begin_m;
+                std::memmove(static_cast<void*>(data_m + gap_begin_m), static_cast<const void*>(data_m + gap_end_m),
+                             n * sizeof(T));
+                gap_begin_m += n;
+                gap_end_m += n;
+            }
+        } else {
+            // one element at a time, so the gap bounds stay exact if a move throws
+            while (gap_begin_m > index) {
+                relocate_one(data_m + gap_begin_m - 1, data_m + gap_end_m - 1);
+                --gap_begin_m;
+                --gap_end_m;
+            }
+            while (gap_begin_m < index) {
+                relocate_one(data_m + gap_end_m, data_m + gap_begin_m);
+                ++gap_begin_m;
+                ++gap_end_m;
+            }
+        }
+    }
+
+    // rebuilds the elements in a block of new_capacity slots with the gap
+    // at index. Each element is relocated once, straight to its final slot:
+    // the elements split into at most three runs of consecutive slots
+    // (before index, and the parts of [0, gap_begin) and [gap_end, capacity)
+    // after it), which land on either side of the new gap.
+    void reallocate (const size_t new_capacity, size_t index) {
+        index = std::min(index, size());
+        const size_t new_gap_end = new_capacity - (size() - index);
+        struct run {
+            T* src;
+            size_t count;
+            size_t dst;
+        };
+        run runs[3];
+        if (index <= gap_begin_m) {
+            runs[0] = {data_m, index, 0};
+            runs[1] = {data_m + index, gap_begin_m - index, new_gap_end};
+            runs[2] = {data_m + gap_end_m, capacity_m - gap_end_m, new_gap_end + (gap_begin_m - index)};
+        } else {
+            const size_t moved = index - gap_begin_m;
+            runs[0] = {data_m, gap_begin_m, 0};
+            runs[1] = {data_m + gap_end_m, moved, gap_begin_m};
+            runs[2] = {data_m + gap_end_m + moved, capacity_m - gap_end_m - moved, new_gap_end};
+        }
+
+        T* new_data_m = allocate(new_capacity);
+        if constexpr (is_trivially_relocatable_v<T>) {
+            for (const run& r : runs) {
+                if (r.count != 0) {
+                    std::memcpy(static_cast<void*>(new_data_m + r.dst), static_cast<const void*>(r.src),
+                                r.count * sizeof(T));
+                }
+            }
+        } else {
+            size_t done = 0;
+            try {
+                for (; done < 3; ++done) {
+                    transfer(runs[done].src, runs[done].count, new_data_m + runs[done].dst);
+                }
+            } catch (...) {
+                for (size_t i = 0; i < done; ++i) {
+                    std::destroy_n(new_data_m + runs[i].dst, runs[i].count);
+                }
+                deallocate(new_data_m, new_capacity);
+                throw;
+            }
+            std::destroy(data_m, data_m + gap_begin_m);
+            std::destroy(data_m + gap_end_m, data_m + capacity_m);
+        }
+        deallocate(data_m, capacity_m);
+        data_m = new_data_m;
+        capacity_m = new_capacity;
+        gap_begin_m = index;
+        gap_end_m = new_gap_end;
+    }
+
+    // makes room for count more elements and puts the gap at index
+    void open_gap (const size_t index, const size_t count) {
+        if (gap_size() < count) {
+            reallocate(Growth::next_capacity(capacity_m, size() + count, sizeof(T)), index);
+        }
+        move_gap(index);
+    }
+
+    template <bool Const>
+    class basic_iterator {
+        using owner = std::conditional_t<Const, const my_gap_vector, my_gap_vector>;
+        friend class basic_iterator<!Const>;
+
+        owner* vector_m = nullptr;
+        size_t index_m = 0;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+        basic_iterator () noexcept = default;
+        basic_iterator (owner* vector, const size_t index) noexcept : vector_m(vector), index_m(index) {}
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        basic_iterator (const basic_iterator<false>& other) noexcept : vector_m(other.vector_m), index_m(other.index_m) {}
+
+        reference operator*() const noexcept {
+            return (*vector_m)[index_m];
+        }
+        pointer operator->() const noexcept {
+            return &(*vector_m)[index_m];
+        }
+        reference operator[](const ptrdiff_t n) const noexcept {
+            return (*vector_m)[index_m + n];
+        }
+        [[nodiscard]] size_t index () const noexcept {
+            return index_m;
+        }
+
+        basic_iterator& operator++() noexcept {
+            ++index_m;
+            return *this;
+        }
+        basic_iterator operator++(int) noexcept {
+            basic_iterator old = *this;
+            ++index_m;
+            return old;
+        }
+        basic_iterator& operator--() noexcept {
+            --index_m;
+            return *this;
+        }
+        basic_iterator operator--(int) noexcept {
+            basic_iterator old = *this;
+            --index_m;
+            return old;
+        }
+        basic_iterator& operator+=(const ptrdiff_t n) noexcept {
+            index_m += n;
+            return *this;
+        }
+        basic_iterator& operator-=(const ptrdiff_t n) noexcept {
+            index_m -= n;
+            return *this;
+        }
+        friend basic_iterator operator+(basic_iterator it, const ptrdiff_t n) noexcept {
+            return it += n;
+        }
+        friend basic_iterator operator+(const ptrdiff_t n, basic_iterator it) noexcept {
+            return it += n;
+        }
+        friend basic_iterator operator-(basic_iterator it, const ptrdiff_t n) noexcept {
+            return it -= n;
+        }
+        friend ptrdiff_t operator-(const basic_iterator& a, const basic_iterator& b) noexcept {
+            return static_cast<ptrdiff_t>(a.index_m) - static_cast<ptrdiff_t>(b.index_m);
+        }
+
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) noexcept {
+            return a.index_m == b.index_m;
+        }
+        friend auto operator<=>(const basic_iterator& a, const basic_iterator& b) noexcept {
+            return a.index_m <=> b.index_m;
+        }
+    };
+
+public:
+    using value_type = T;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    // constructors
+    my_gap_vector () noexcept = default;
+    my_gap_vector (const size_t n, const T& value) : data_m(allocate(n)), capacity_m(n), gap_begin_m(n), gap_end_m(n) {
+        try {
+            std::uninitialized_fill_n(data_m, n, value);
+        } catch (...) {
+            deallocate(data_m, capacity_m);
+            throw;
+        }
+    }
+    my_gap_vector (std::initializer_list<T> init) : my_gap_vector(init.begin(), init.end()) {}
+    template<typename InputIt, typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+    my_gap_vector (InputIt first, InputIt last) {
+        try {
+            insert(size(), first, last);
+        } catch (...) {
+            destroy_all();
+            throw;
+        }
+    }
+
+    // copy: the copy has its gap at the end
+    my_gap_vector (const my_gap_vector& other)
+        : data_m(allocate(other.size())), capacity_m(other.size()), gap_begin_m(other.size()), gap_end_m(other.size()) {
+        try {
+            std::uninitialized_copy_n(other.data_m, other.gap_begin_m, data_m);
+            try {
+                std::uninitialized_copy(other.data_m + other.gap_end_m, other.data_m + other.capacity_m,
+                                        data_m + other.gap_begin_m);
+            } catch (...) {
+                std::destroy_n(data_m, other.gap_begin_m);
+                throw;
+            }
+        } catch (...) {
+            deallocate(data_m, capacity_m);
+            throw;
+        }
+    }
+    my_gap_vector& operator=(const my_gap_vector& other) {
+        if (this != &other) {
+            my_gap_vector copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    // move
+    my_gap_vector (my_gap_vector&& other) noexcept {
+        swap(other);
+    }
+    my_gap_vector& operator=(my_gap_vector&& other) noexcept {
+        if (this != &other) {
+            destroy_all();
+            data_m = std::exchange(other.data_m, nullptr);
+            capacity_m = std::exchange(other.capacity_m, 0);
+            gap_begin_m = std::exchange(other.gap_begin_m, 0);
+            gap_end_m = std::exchange(other.gap_end_m, 0);
+        }
+        return *this;
+    }
+
+    // destructor
+    ~my_gap_vector() {
+        destroy_all();
+    }
+
+    // access operators
+    T& operator[](const size_t index) {
+        return data_m[slot(index)];
+    }
+    const T& operator[](const size_t index) const {
+        return data_m[slot(index)];
+    }
+
+    T& at(const size_t index) {
+        if (index >= size()) {
+            throw std::out_of_range("Index out of range in at()");
+        }
+        return (*this)[index];
+    }
+    const T& at(const size_t index) const {
+        if (index >= size()) {
+            throw std::out_of_range("Index out of range in at()");
+        }
+        return (*this)[index];
+    }
+
+    T& back() {
+        if (is_empty()) {
+            throw std::out_of_range("Accessing empty vector in back()");
+        }
+        return (*this)[size() - 1];
+    }
+    const T& back() const {
+        if (is_empty()) {
+            throw std::out_of_range("Accessing empty vector in back()");
+        }
+        return (*this)[size() - 1];
+    }
+    T& front() {
+        if (is_empty()) {
+            throw std::out_of_range("Accessing empty vector in front()");
+        }
+        return (*this)[0];
+    }
+    const T& front() const {
+        if (is_empty()) {
+            throw std::out_of_range("Accessing empty vector in front()");
+        }
+        return (*this)[0];
+    }
+
+    // iterators
+    iterator begin() noexcept {
+        return iterator(this, 0);
+    }
+    iterator end() noexcept {
+        return iterator(this, size());
+    }
+    const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+    const_iterator end() const noexcept {
+        return const_iterator(this, size());
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    // additional methods
+    [[nodiscard]] bool is_empty() const noexcept {
+        return size() == 0;
+    }
+    [[nodiscard]] size_t size() const noexcept {
+        return capacity_m - gap_size();
+    }
+    [[nodiscard]] size_t capacity() const noexcept {
+        return capacity_m;
+    }
+    // index where the gap is: edits here do not move any element
+    [[nodiscard]] size_t cursor() const noexcept {
+        return gap_begin_m;
+    }
+    void reserve (const size_t new_capacity) {
+        if (new_capacity > capacity_m) {
+            reallocate(new_capacity, gap_begin_m);
+        }
+    }
+    void shrink_to_fit () {
+        if (gap_size() != 0) {
+            reallocate(size(), gap_begin_m);
+        }
+    }
+
+    // closes the gap by moving it to the end and views the elements in
+    // place; valid until the next insert, erase or reallocation
+    my_span<T> contiguous () {
+        move_gap(size());
+        return my_span<T>(data_m, size());
+    }
+
+    // swap
+    void swap (my_gap_vector& other) noexcept {
+        std::swap(data_m, other.data_m);
+        std::swap(capacity_m, other.capacity_m);
+        std::swap(gap_begin_m, other.gap_begin_m);
+        std::swap(gap_end_m, other.gap_end_m);
+    }
+
+    // clear, resize
+    void clear () noexcept {
+        std::destroy(data_m, data_m + gap_begin_m);
+        std::destroy(data_m + gap_end_m, data_m + capacity_m);
+        gap_begin_m = 0;
+        gap_end_m = capacity_m;
+    }
+    void resize (const size_t new_size) {
+        if (new_size < size()) {
+            erase(new_size, size() - new_size);
+            return;
+        }
+        open_gap(size(), new_size - size());
+        std::uninitialized_value_construct(data_m + gap_begin_m, data_m + gap_begin_m + (new_size - size()));
+        gap_begin_m += new_size - size();
+    }
+
+    // inserts; index may be anywhere in [0, size()]
+    template<typename... Args>
+    T& emplace (const size_t index, Args&&... args) {
+        if (index > size()) {
+            throw std::out_of_range("Index out of range in emplace()");
+        }
+        // args may refer to an element that moves with the gap
+        T tmp(std::forward<Args>(args)...);
+        open_gap(index, 1);
+        std::construct_at(data_m + gap_begin_m, std::move(tmp));
+        return data_m[gap_begin_m++];
+    }
+    T& insert (const size_t index, const T& value) {
+        return emplace(index, value);
+    }
+    T& insert (const size_t index, T&& value) {
+        return emplace(index, std::move(value));
+    }
+    // inserts [first, last) before index, which ends up just after the cursor
+    template<typename InputIt>
+    void insert (const size_t index, InputIt first, InputIt last) {
+        if (index > size()) {
+            throw std::out_of_range("Index out of range in insert()");
+        }
+        using category = typename std::iterator_traits<InputIt>::iterator_category;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+            open_gap(index, static_cast<size_t>(std::distance(first, last)));
+        } else {
+            move_gap(std::min(index, size()));
+        }
+        for (; first != last; ++first) {
+            if (gap_size() == 0) {
+                open_gap(gap_begin_m, 1);
+            }
+            std::construct_at(data_m + gap_begin_m, *first);
+            ++gap_begin_m;
+        }
+    }
+
+    // erase count elements starting at index
+    void erase (const size_t index, const size_t count = 1) {
+        if (index > size() || count > size() - index) {
+            throw std::out_of_range("Range out of bounds in erase()");
+        }
+        move_gap(index);
+        std::destroy(data_m + gap_end_m, data_m + gap_end_m + count);
+        gap_end_m += count;
+    }
+
+    // pop, push
+    void pop_back() {
+        if (!is_empty()) {
+            erase(size() - 1);
+        }
+    }
+    void push_back(const T& value) {
+        emplace(size(), value);
+    }
+    void push_back(T&& value) {
+        emplace(size(), std::move(value));
+    }
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        return emplace(size(), std::forward<Args>(args)...);
+    }
+
+    friend bool operator==(const my_gap_vector& a, const my_gap_vector& b) {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+    }
+
+    friend bool operator!=(const my_gap_vector& a, const my_gap_vector& b) {
+        return !(a == b);
+    }
+
+    // <, >, <= and >= are rewritten in terms of <=>, one pass per comparison
+    friend auto operator<=>(const my_gap_vector& a, const my_gap_vector& b) {
+        return std::lexicographical_compare_three_way(a.begin(), a.end(), b.begin(), b.end(), synth_three_way());
+    }
+
+};
+
+
+
+#endif //MY_GAP_VECTOR_H
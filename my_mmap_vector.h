@@ -0,0 +1,419 @@
+#ifndef MY_MMAP_VECTOR_H
+#define MY_MMAP_VECTOR_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "growth_policy.h"
+#include "relocation.h"
+#include "simd_compare.h"
+#include "simd_fill.h"
+
+// my_vector whose elements live in a file mapped with mmap, for datasets
+// larger than RAM or that have to survive a restart. Opening an existing
+// file only maps it, so startup does not depend on the dataset size; pages
+// are read in by the kernel as they are touched.
+//
+// The file starts with a 64-byte header holding the element size and the
+// current size, followed by the capacity in elements. Growing extends the
+// file with ftruncate and the mapping with mremap (munmap + mmap where
+// mremap is not available). Only trivially copyable types can be stored,
+// as the bytes are reused as-is by the next process that opens the file.
+template <typename T, typename Growth = growth_factor_2>
+class my_mmap_vector {
+    static_assert(std::is_trivially_copyable_v<T>, "my_mmap_vector stores raw bytes, T must be trivially copyable");
+    static_assert(alignof(T) <= 64, "elements must fit the alignment of the data offset");
+
+    struct file_header {
+        char magic[8];
+        uint64_t element_size;
+        uint64_t size;
+        unsigned char reserved[40];
+    };
+    static_assert(sizeof(file_header) == 64);
+
+    static constexpr char magic[8] = {'M', 'Y', 'V', 'E', 'C', 'M', 'M', '1'};
+    static constexpr size_t data_offset = sizeof(file_header);
+
+    int fd_m = -1;
+    unsigned char* map_m = nullptr;
+    size_t map_bytes_m = 0;
+    size_t capacity_m = 0;
+
+    [[nodiscard]] static size_t page_size () {
+        static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return page;
+    }
+
+    [[noreturn]] static void throw_errno (const char* what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    [[nodiscard]] file_header* header () const noexcept {
+        return reinterpret_cast<file_header*>(map_m);
+    }
+    [[nodiscard]] T* data_ptr () const noexcept {
+        return reinterpret_cast<T*>(map_m + data_offset);
+    }
+    [[nodiscard]] uint64_t& size_ref () const noexcept {
+        return header()->size;
+    }
+
+    // whole pages, so the slack at the end of the last page becomes capacity
+    [[nodiscard]] static size_t bytes_for (const size_t capacity) {
+        return round_up_to(data_offset + capacity * sizeof(T), page_size());
+    }
+
+    void map (const size_t bytes) {
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_m, 0);
+        if (p == MAP_FAILED) {
+            throw_errno("mmap");
+        }
+        map_m = static_cast<unsigned char*>(p);
+        map_bytes_m = bytes;
+        capacity_m = (bytes - data_offset) / sizeof(T);
+    }
+
+    // grows or shrinks the file and the mapping to bytes; the elements stay
+    // where the file has them, only the address of the mapping may change
+    void remap (const size_t bytes) {
+        if (bytes > map_bytes_m && ftruncate(fd_m, static_cast<off_t>(bytes)) != 0) {
+            throw_errno("ftruncate");
+        }
+#ifdef MREMAP_MAYMOVE
+        void* p = mremap(map_m, map_bytes_m, bytes, MREMAP_MAYMOVE);
+        if (p == MAP_FAILED) {
+            throw_errno("mremap");
+        }
+        map_m = static_cast<unsigned char*>(p);
+        map_bytes_m = bytes;
+        capacity_m = (bytes - data_offset) / sizeof(T);
+#else
+        unmap();
+        map(bytes);
+#endif
+        if (bytes < static_cast<size_t>(file_bytes()) && ftruncate(fd_m, static_cast<off_t>(bytes)) != 0) {
+            throw_errno("ftruncate");
+        }
+    }
+
+    [[nodiscard]] off_t file_bytes () const {
+        struct stat st {};
+        if (fstat(fd_m, &st) != 0) {
+            throw_errno("fstat");
+        }
+        return st.st_size;
+    }
+
+    void unmap () noexcept {
+        if (map_m != nullptr) {
+            munmap(map_m, map_bytes_m);
+            map_m = nullptr;
+        }
+    }
+    void close_file () noexcept {
+        unmap();
+        if (fd_m != -1) {
+            close(fd_m);
+            fd_m = -1;
+        }
+    }
+
+    void grow_to_fit (const size_t required) {
+        if (required > capacity_m) {
+            remap(bytes_for(Growth::next_capacity(capacity_m, required, sizeof(T))));
+        }
+    }
+
+    void open_file (const char* path) {
+        fd_m = open(path, O_RDWR | O_CREAT, 0644);
+        if (fd_m == -1) {
+            throw_errno("open");
+        }
+        try {
+            const auto existing = static_cast<size_t>(file_bytes());
+            if (existing == 0) {
+                if (ftruncate(fd_m, static_cast<off_t>(bytes_for(0))) != 0) {
+                    throw_errno("ftruncate");
+                }
+                map(bytes_for(0));
+                std::memcpy(header()->magic, magic, sizeof(magic));
+                header()->element_size = sizeof(T);
+                header()->size = 0;
+                return;
+            }
+            if (existing < data_offset) {
+                throw std::runtime_error("File is too short to hold a my_mmap_vector header");
+            }
+            map(existing);
+            if (std::memcmp(header()->magic, magic, sizeof(magic)) != 0) {
+                throw std::runtime_error("File is not a my_mmap_vector");
+            }
+            if (header()->element_size != sizeof(T) || header()->size > capacity_m) {
+                throw std::runtime_error("File was written for a different element type");
+            }
+        } catch (...) {
+            close_file();
+            throw;
+        }
+    }
+
+public:
+    using value_type = T;
+
+    // hints passed to madvise for the mapped elements
+    enum class access_pattern {
+        normal = MADV_NORMAL,
+        sequential = MADV_SEQUENTIAL,
+        random = MADV_RANDOM,
+        willneed = MADV_WILLNEED,
+        dontneed = MADV_DONTNEED,
+    };
+
+    // maps path, creating an empty vector if the file does not exist yet
+    explicit my_mmap_vector (const char* path) {
+        open_file(path);
+    }
+    explicit my_mmap_vector (const std::string& path) : my_mmap_vector(path.c_str()) {}
+
+    my_mmap_vector (const my_mmap_vector&) = delete;
+    my_mmap_vector& operator=(const my_mmap_vector&) = delete;
+
+    // a moved-from vector may only be destroyed or assigned to
+    my_mmap_vector (my_mmap_vector&& other) noexcept
+        : fd_m(std::exchange(other.fd_m, -1)),
+          map_m(std::exchange(other.map_m, nullptr)),
+          map_bytes_m(std::exchange(other.map_bytes_m, 0)),
+          capacity_m(std::exchange(other.capacity_m, 0)) {}
+
+    my_mmap_vector& operator=(my_mmap_vector&& other) noexcept {
+        if (this != &other) {
+            close_file();
+            fd_m = std::exchange(other.fd_m, -1);
+            map_m = std::exchange(other.map_m, nullptr);
+            map_bytes_m = std::exchange(other.map_bytes_m, 0);
+            capacity_m = std::exchange(other.capacity_m, 0);
+        }
+        return *this;
+    }
+
+    // the contents stay in the file; the kernel writes dirty pages back
+    ~my_mmap_vector() {
+        close_file();
+    }
+
+    // access operators
+    T& operator[](const size_t index) {
+        return data_ptr()[index];
+    }
+    const T& operator[](const size_t index) const {
+        return data_ptr()[index];
+    }
+
+    T& at(const size_t index) {
+        if (index >= size()) {
+            throw std::out_of_range("Index out of range in at()");
+        }
+        return data_ptr()[index];
+    }
+    const T& at(const size_t index) const {
+        if (index >= size()) {
+            throw std::out_of_range("Index out of range in at()");
+        }
+        return data_ptr()[index];
+    }
+
+    T& front() {
+        if (is_empty()) {
+            throw std::out_of_range("Accessing empty vector in front()");
+        }
+        return data_ptr()[0];
+    }
+    const T& front() const {
+        if (is_empty()) {
+            throw std::out_of_range("Accessing empty vector in front()");
+        }
+        return data_ptr()[0];
+    }
+    T& back() {
+        if (is_empty()) {
+            throw std::out_of_range("Accessing empty vector in back()");
+        }
+        return data_ptr()[size() - 1];
+    }
+    const T& back() const {
+        if (is_empty()) {
+            throw std::out_of_range("Accessing empty vector in back()");
+        }
+        return data_ptr()[size() - 1];
+    }
+
+    // iterators
+    T* begin() {
+        return data_ptr();
+    }
+    T* end() {
+        return data_ptr() + size();
+    }
+    const T* begin() const {
+        return data_ptr();
+    }
+    const T* end() const {
+        return data_ptr() + size();
+    }
+    const T* cbegin() const {
+        return data_ptr();
+    }
+    const T* cend() const {
+        return data_ptr() + size();
+    }
+    std::reverse_iterator<T*> rbegin() {
+        return std::reverse_iterator<T*>(end());
+    }
+    std::reverse_iterator<T*> rend() {
+        return std::reverse_iterator<T*>(begin());
+    }
+    std::reverse_iterator<const T*> rcbegin() const {
+        return std::reverse_iterator<const T*>(cend());
+    }
+    std::reverse_iterator<const T*> rcend() const {
+        return std::reverse_iterator<const T*>(cbegin());
+    }
+
+    // additional methods
+    [[nodiscard]] bool is_empty() const {
+        return size() == 0;
+    }
+    [[nodiscard]] size_t size() const {
+        return static_cast<size_t>(size_ref());
+    }
+    T* data() {
+        return data_ptr();
+    }
+    const T* data() const {
+        return data_ptr();
+    }
+    [[nodiscard]] size_t capacity() const {
+        return capacity_m;
+    }
+    void reserve (const size_t new_capacity) {
+        if (new_capacity > capacity_m) {
+            remap(bytes_for(new_capacity));
+        }
+    }
+    // also gives the unused tail of the file back to the file system
+    void shrink_to_fit () {
+        if (bytes_for(size()) != map_bytes_m) {
+            remap(bytes_for(size()));
+        }
+    }
+
+    // madvise over the pages that hold elements
+    void advise (const access_pattern pattern) {
+        if (madvise(map_m, map_bytes_m, static_cast<int>(pattern)) != 0) {
+            throw_errno("madvise");
+        }
+    }
+    // blocks until the elements written so far are on disk
+    void flush () {
+        if (msync(map_m, map_bytes_m, MS_SYNC) != 0) {
+            throw_errno("msync");
+        }
+    }
+
+    // clear, resize
+    void clear () {
+        size_ref() = 0;
+    }
+    void resize(const size_t new_size) {
+        resize(new_size, T());
+    }
+    void resize(const size_t new_size, const T& value) {
+        if (new_size > size()) {
+            const T copy = value;
+            grow_to_fit(new_size);
+            fill_elements(data_ptr() + size(), new_size - size(), copy);
+        }
+        size_ref() = new_size;
+    }
+
+    // inserts
+    T* insert(T* it, const T& value) {
+        const size_t index = it - data_ptr();
+        const T copy = value;
+        grow_to_fit(size() + 1);
+        T* pos = data_ptr() + index;
+        move_elements(pos, end(), pos + 1);
+        *pos = copy;
+        ++size_ref();
+        return pos;
+    }
+
+    template<typename InputIt>
+    T* insert(T* it, InputIt first, InputIt last) {
+        const size_t index = it - data_ptr();
+        const size_t count = std::distance(first, last);
+        grow_to_fit(size() + count);
+        T* pos = data_ptr() + index;
+        move_elements(pos, end(), pos + count);
+        std::copy(first, last, pos);
+        size_ref() += count;
+        return pos;
+    }
+
+    // erase
+    T* erase(T* pos) {
+        return erase(pos, pos + 1);
+    }
+    T* erase(T* first, T* last) {
+        move_elements(last, end(), first);
+        size_ref() -= last - first;
+        return first;
+    }
+
+    // pop, push, emplace
+    void pop_back() {
+        if (size() > 0) {
+            --size_ref();
+        }
+    }
+    void push_back(const T& value) {
+        emplace_back(value);
+    }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        // built first, args may refer to an element of the old mapping
+        const T value(std::forward<Args>(args)...);
+        grow_to_fit(size() + 1);
+        T* slot = data_ptr() + size();
+        std::memcpy(static_cast<void*>(slot), &value, sizeof(T));
+        ++size_ref();
+        return *slot;
+    }
+
+    friend bool operator==(const my_mmap_vector& a, const my_mmap_vector& b) {
+        return a.size() == b.size() && elements_equal(a.data(), b.data(), a.size());
+    }
+
+    friend bool operator!=(const my_mmap_vector& a, const my_mmap_vector& b) {
+        return !(a == b);
+    }
+
+    friend auto operator<=>(const my_mmap_vector& a, const my_mmap_vector& b) {
+        return elements_compare(a.data(), a.size(), b.data(), b.size());
+    }
+};
+
+#endif //MY_MMAP_VECTOR_H
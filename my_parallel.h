@@ -0,0 +1,310 @@
+#ifndef MY_PARALLEL_H
+#define MY_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "thread_pool.h"
+
+// Parallel sort, stable_sort, transform, reduce, count_if and find_if
+// over random-access ranges with begin() and size(): my_vector, my_array,
+// my_span and my_strided_view. The range is cut into chunks that run on a
+// thread_pool;
+// inputs shorter than parallel_serial_cutoff are processed serially, as
+// the fork-join overhead would outweigh the work.
+
+inline constexpr size_t parallel_serial_cutoff = size_t(1) << 14;
+
+namespace parallel_detail {
+    // smallest chunk worth a task of its own
+    inline constexpr size_t min_chunk = parallel_serial_cutoff / 4;
+
+    inline bool runs_serial (const size_t n, const thread_pool& pool) {
+        return n < parallel_serial_cutoff || pool.concurrency() == 1;
+    }
+
+    // a few chunks per thread, so stealing can even out uneven chunks
+    inline size_t chunk_count (const size_t n, const thread_pool& pool) {
+        const size_t by_size = (n + min_chunk - 1) / min_chunk;
+        return std::max<size_t>(1, std::min(by_size, pool.concurrency() * 4));
+    }
+
+    inline size_t chunk_begin (const size_t n, const size_t chunks, const size_t k) {
+        return n / chunks * k + std::min(k, n % chunks);
+    }
+
+    // calls f(begin, end, k) for every chunk k of [0, n)
+    template <typename F>
+    void for_each_chunk (thread_pool& pool, const size_t n, const size_t chunks, F&& f) {
+        pool.parallel_for(chunks, [&](const size_t k) {
+            f(chunk_begin(n, chunks, k), chunk_begin(n, chunks, k + 1), k);
+        });
+    }
+
+    // number of elements of a among the first d of the stable merge of
+    // a and b; equal elements are taken from a first
+    template <typename It, typename Compare>
+    size_t merge_split (const It a, const size_t na, const It b, const size_t nb, const size_t d, Compare& comp) {
+        size_t lo = d > nb ? d - nb : 0;
+        size_t hi = std::min(d, na);
+        while (lo < hi) {
+            const size_t mid = lo + (hi - lo) / 2;
+            if (comp(b[d - mid - 1], a[mid])) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+        }
+        return lo;
+    }
+
+    // move-constructs the merge of a[i..ie) and b[j..je) into raw storage
+    // at out; on throw the elements constructed so far are destroyed
+    template <typename It, typename T, typename Compare>
+    void merge_into (const It a, size_t i, const size_t ie, const It b, size_t j, const size_t je, T* out, Compare& comp) {
+        T* const start = out;
+        try {
+            while (i < ie && j < je) {
+                if (comp(b[j], a[i])) {
+                    std::construct_at(out++, std::move(b[j++]));
+                } else {
+                    std::construct_at(out++, std::move(a[i++]));
+                }
+            }
+            out = std::uninitialized_move(a + i, a + ie, out);
+            std::uninitialized_move(b + j, b + je, out);
+        } catch (...) {
+            std::destroy(start, out);
+            throw;
+        }
+    }
+
+    // sorts the chunks independently, then merges neighbouring runs pairwise
+    // until one is left. Every merge round is split along the merge path,
+    // so all threads stay busy even when only two runs remain.
+    template <bool Stable, typename It, typename Compare>
+    void merge_sort (const It first, const size_t n, Compare comp, thread_pool& pool) {
+        using T = std::iter_value_t<It>;
+        if (runs_serial(n, pool)) {
+            if constexpr (Stable) {
+                std::stable_sort(first, first + n, comp);
+            } else {
+                std::sort(first, first + n, comp);
+            }
+            return;
+        }
+
+        const size_t chunks = chunk_count(n, pool);
+        std::vector<size_t> runs;
+        for (size_t k = 0; k <= chunks; ++k) {
+            runs.push_back(chunk_begin(n, chunks, k));
+        }
+        for_each_chunk(pool, n, chunks, [&](const size_t b, const size_t e, size_t) {
+            if constexpr (Stable) {
+                std::stable_sort(first + b, first + e, comp);
+            } else {
+                std::sort(first + b, first + e, comp);
+            }
+        });
+
+        std::allocator<T> alloc;
+        T* const buffer = alloc.allocate(n);
+        try {
+            while (runs.size() > 2) {
+                const size_t pairs = (runs.size() - 1) / 2;
+                const size_t parts = std::max<size_t>(1, (pool.concurrency() * 2 + pairs - 1) / pairs);
+                const bool odd = (runs.size() - 1) % 2 != 0;
+                const size_t tasks = pairs * parts + (odd ? 1 : 0);
+
+                // every split point of the round is found before any task
+                // moves an element out of the runs it searches: splits[pair
+                // * (parts + 1) + p] is how many elements of the pair's first
+                // run go before output position d_p
+                std::vector<size_t> splits(pairs * (parts + 1));
+                pool.parallel_for(splits.size(), [&](const size_t s) {
+                    const size_t pair = s / (parts + 1);
+                    const size_t p = s % (parts + 1);
+                    const size_t base = runs[2 * pair];
+                    const size_t mid = runs[2 * pair + 1];
+                    const size_t na = mid - base;
+                    const size_t nb = runs[2 * pair + 2] - mid;
+                    splits[s] = merge_split(first + base, na, first + mid, nb, (na + nb) * p / parts, comp);
+                });
+
+                std::vector<char> done(tasks, 0);
+                try {
+                    pool.parallel_for(tasks, [&](const size_t t) {
+                        if (t == pairs * parts) {
+                            // the unpaired last run is carried over unchanged
+                            const size_t b = runs[runs.size() - 2];
+                            const size_t e = runs.back();
+                            std::uninitialized_move(first + b, first + e, buffer + b);
+                        } else {
+                            const size_t pair = t / parts;
+                            const size_t part = t % parts;
+                            const size_t base = runs[2 * pair];
+                            const size_t mid = runs[2 * pair + 1];
+                            const size_t na = mid - base;
+                            const size_t nb = runs[2 * pair + 2] - mid;
+                            const size_t d0 = (na + nb) * part / parts;
+                            const size_t d1 = (na + nb) * (part + 1) / parts;
+                            const size_t i0 = splits[pair * (parts + 1) + part];
+                            const size_t i1 = splits[pair * (parts + 1) + part + 1];
+                            merge_into(first + base, i0, i1, first + mid, d0 - i0, d1 - i1, buffer + base + d0, comp);
+                        }
+                        done[t] = 1;
+                    });
+                } catch (...) {
+                    // the completed tasks left their output in the buffer
+                    for (size_t t = 0; t < tasks; ++t) {
+                        if (done[t] == 0) {
+                            continue;
+                        }
+                        if (t == pairs * parts) {
+                            std::destroy(buffer + runs[runs.size() - 2], buffer + runs.back());
+                        } else {
+                            const size_t pair = t / parts;
+                            const size_t part = t % parts;
+                            const size_t base = runs[2 * pair];
+                            const size_t len = runs[2 * pair + 2] - base;
+                            std::destroy(buffer + base + len * part / parts, buffer + base + len * (part + 1) / parts);
+                        }
+                    }
+                    throw;
+                }
+
+                // move the round back; the buffer is raw storage again afterwards
+                for_each_chunk(pool, n, chunks, [&](const size_t b, const size_t e, size_t) {
+                    struct destroy_guard {
+                        T* from;
+                        T* to;
+                        ~destroy_guard() {
+                            std::destroy(from, to);
+                        }
+                    } guard {buffer + b, buffer + e};
+                    std::move(buffer + b, buffer + e, first + b);
+                });
+
+                std::vector<size_t> merged;
+                for (size_t r = 0; r < runs.size(); r += 2) {
+                    merged.push_back(runs[r]);
+                }
+                if (merged.back() != n) {
+                    merged.push_back(n);
+                }
+                runs = std::move(merged);
+            }
+        } catch (...) {
+            alloc.deallocate(buffer, n);
+            throw;
+        }
+        alloc.deallocate(buffer, n);
+    }
+}
+
+// sort
+// (views are taken by forwarding reference, so a temporary slice such as
+// v.subspan(i, n) can be passed directly)
+template <typename Container, typename Compare = std::less<>>
+void parallel_sort (Container&& c, Compare comp = Compare(), thread_pool& pool = thread_pool::global()) {
+    parallel_detail::merge_sort<false>(c.begin(), c.size(), comp, pool);
+}
+
+template <typename Container, typename Compare = std::less<>>
+void parallel_stable_sort (Container&& c, Compare comp = Compare(), thread_pool& pool = thread_pool::global()) {
+    parallel_detail::merge_sort<true>(c.begin(), c.size(), comp, pool);
+}
+
+// transform: dst[i] = f(src[i]); dst may be src itself
+template <typename Source, typename Destination, typename F>
+void parallel_transform (const Source& src, Destination&& dst, F f, thread_pool& pool = thread_pool::global()) {
+    const size_t n = src.size();
+    if (dst.size() < n) {
+        throw std::out_of_range("Destination is shorter than source in parallel_transform()");
+    }
+    const auto in = src.begin();
+    const auto out = dst.begin();
+    if (parallel_detail::runs_serial(n, pool)) {
+        std::transform(in, in + n, out, f);
+        return;
+    }
+    parallel_detail::for_each_chunk(pool, n, parallel_detail::chunk_count(n, pool),
+                                    [&](const size_t b, const size_t e, size_t) {
+        std::transform(in + b, in + e, out + b, f);
+    });
+}
+
+// reduce: op must be associative; the chunk results are combined in order,
+// so it does not have to be commutative
+template <typename Container, typename T, typename Op = std::plus<>>
+T parallel_reduce (const Container& c, T init, Op op = Op(), thread_pool& pool = thread_pool::global()) {
+    const size_t n = c.size();
+    const auto in = c.begin();
+    if (parallel_detail::runs_serial(n, pool)) {
+        for (size_t i = 0; i < n; ++i) {
+            init = op(std::move(init), in[i]);
+        }
+        return init;
+    }
+    const size_t chunks = parallel_detail::chunk_count(n, pool);
+    std::vector<std::unique_ptr<T>> partials(chunks);
+    parallel_detail::for_each_chunk(pool, n, chunks, [&](const size_t b, const size_t e, const size_t k) {
+        T acc(in[b]);
+        for (size_t i = b + 1; i < e; ++i) {
+            acc = op(std::move(acc), in[i]);
+        }
+        partials[k] = std::make_unique<T>(std::move(acc));
+    });
+    for (auto& partial : partials) {
+        init = op(std::move(init), std::move(*partial));
+    }
+    return init;
+}
+
+// count_if
+template <typename Container, typename Predicate>
+size_t parallel_count_if (const Container& c, Predicate pred, thread_pool& pool = thread_pool::global()) {
+    const size_t n = c.size();
+    const auto in = c.begin();
+    if (parallel_detail::runs_serial(n, pool)) {
+        return static_cast<size_t>(std::count_if(in, in + n, pred));
+    }
+    std::atomic<size_t> total {0};
+    parallel_detail::for_each_chunk(pool, n, parallel_detail::chunk_count(n, pool),
+                                    [&](const size_t b, const size_t e, size_t) {
+        total.fetch_add(static_cast<size_t>(std::count_if(in + b, in + e, pred)), std::memory_order_relaxed);
+    });
+    return total.load();
+}
+
+// find_if: iterator to the first matching element, or end() if there is
+// none. Chunks that start after a match found elsewhere are skipped.
+template <typename Container, typename Predicate>
+auto parallel_find_if (Container&& c, Predicate pred, thread_pool& pool = thread_pool::global()) {
+    const size_t n = c.size();
+    const auto in = c.begin();
+    if (parallel_detail::runs_serial(n, pool)) {
+        return std::find_if(in, in + n, pred);
+    }
+    std::atomic<size_t> found {n};
+    parallel_detail::for_each_chunk(pool, n, parallel_detail::chunk_count(n, pool),
+                                    [&](const size_t b, const size_t e, size_t) {
+        if (b >= found.load(std::memory_order_relaxed)) {
+            return;
+        }
+        const size_t i = static_cast<size_t>(std::find_if(in + b, in + e, pred) - in);
+        if (i == e) {
+            return;
+        }
+        size_t best = found.load(std::memory_order_relaxed);
+        while (i < best && !found.compare_exchange_weak(best, i, std::memory_order_relaxed)) {}
+    });
+    return in + found.load();
+}
+
+#endif //MY_PARALLEL_H
@@ -0,0 +1,253 @@
+#ifndef MY_RING_H
+#define MY_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+// Bounded ring buffer of N elements (a power of two) in inline storage,
+// for handing items between pipeline threads without a mutex.
+//
+//  - spsc: one producer thread and one consumer thread. Every call is
+//    wait-free: a fixed number of steps, no retry loop.
+//  - mpmc: any number of producers and consumers. Slots carry a sequence
+//    number (Vyukov's bounded queue), so calls are lock-free: a thread
+//    retries only when another thread has made progress.
+//
+// The producer and consumer positions live on separate cache lines, so the
+// two sides do not invalidate each other's line on every call. push_n and
+// pop_n move a whole batch with one atomic update of a position.
+enum class ring_mode {
+    spsc,
+    mpmc
+};
+
+template <typename T, size_t N, ring_mode Mode = ring_mode::spsc>
+class my_ring {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "my_ring capacity must be a power of two");
+    // an element is only published after it is constructed, and a slot
+    // claimed by a thread cannot be given back
+    static_assert(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>
+                  && std::is_nothrow_destructible_v<T>, "my_ring elements must move without throwing");
+
+    static constexpr size_t cache_line = 64;
+    static constexpr size_t mask = N - 1;
+
+    struct spsc_slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+    // sequence == position: free for the producer of that position;
+    // sequence == position + 1: holds the element written at position
+    struct mpmc_slot {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+    using slot = std::conditional_t<Mode == ring_mode::spsc, spsc_slot, mpmc_slot>;
+
+    // consumer side: next position to pop, and in spsc mode the consumer's
+    // last view of tail_m
+    alignas(cache_line) std::atomic<size_t> head_m {0};
+    size_t cached_tail_m = 0;
+    // producer side: next position to push, and the producer's last view of head_m
+    alignas(cache_line) std::atomic<size_t> tail_m {0};
+    size_t cached_head_m = 0;
+    alignas(cache_line) slot slots_m[N];
+
+    [[nodiscard]] T* element (const size_t position) noexcept {
+        return reinterpret_cast<T*>(slots_m[position & mask].storage);
+    }
+
+    // spsc: free slots as seen by the producer, refreshing its view of head
+    // only when the cached one is not enough
+    [[nodiscard]] size_t free_slots (const size_t tail, const size_t wanted) noexcept {
+        size_t free = N - (tail - cached_head_m);
+        if (free < wanted) {
+            cached_head_m = head_m.load(std::memory_order_acquire);
+            free = N - (tail - cached_head_m);
+        }
+        return free;
+    }
+    [[nodiscard]] size_t filled_slots (const size_t head, const size_t wanted) noexcept {
+        size_t filled = cached_tail_m - head;
+        if (filled < wanted) {
+            cached_tail_m = tail_m.load(std::memory_order_acquire);
+            filled = cached_tail_m - head;
+        }
+        return filled;
+    }
+
+    // mpmc: claims up to wanted consecutive positions whose slots are in the
+    // state ready_offset (0 = free, 1 = full); returns the first position
+    // and the count, which is 0 when the ring is full (empty)
+    std::pair<size_t, size_t> claim (std::atomic<size_t>& position, const size_t wanted, const size_t ready_offset) noexcept {
+        size_t first = position.load(std::memory_order_relaxed);
+        while (true) {
+            size_t count = 0;
+            while (count < wanted
+                   && slots_m[(first + count) & mask].sequence.load(std::memory_order_acquire) == first + count + ready_offset) {
+                ++count;
+            }
+            if (count == 0) {
+                const size_t sequence = slots_m[first & mask].sequence.load(std::memory_order_acquire);
+                if (sequence < first + ready_offset) {
+                    return {first, 0}; // the other side has not caught up yet
+                }
+                first = position.load(std::memory_order_relaxed); // lost a race, retry
+                continue;
+            }
+            if (position.compare_exchange_weak(first, first + count, std::memory_order_relaxed)) {
+                return {first, count};
+            }
+        }
+    }
+
+    // constructs up to count elements from src at the producer end and
+    // returns how many fit; spsc publishes the ones made so far if a
+    // constructor throws
+    template <typename InputIt>
+    size_t push_batch (InputIt src, const size_t count) {
+        if constexpr (Mode == ring_mode::spsc) {
+            const size_t tail = tail_m.load(std::memory_order_relaxed);
+            const size_t n = std::min(count, free_slots(tail, count));
+            size_t i = 0;
+            try {
+                for (; i < n; ++i, ++src) {
+                    std::construct_at(element(tail + i), *src);
+                }
+            } catch (...) {
+                tail_m.store(tail + i, std::memory_order_release);
+                throw;
+            }
+            tail_m.store(tail + n, std::memory_order_release);
+            return n;
+        } else {
+            static_assert(std::is_nothrow_constructible_v<T, std::iter_reference_t<InputIt>>,
+                          "mpmc batches are constructed in claimed slots and must not throw");
+            const auto [first, n] = claim(tail_m, count, 0);
+            for (size_t i = 0; i < n; ++i, ++src) {
+                std::construct_at(element(first + i), *src);
+                slots_m[(first + i) & mask].sequence.store(first + i + 1, std::memory_order_release);
+            }
+            return n;
+        }
+    }
+
+    // hands up to count elements to sink(T&) in order, then frees their slots
+    template <typename Sink>
+    size_t pop_batch (const size_t count, Sink&& sink) noexcept {
+        if constexpr (Mode == ring_mode::spsc) {
+            const size_t head = head_m.load(std::memory_order_relaxed);
+            const size_t n = std::min(count, filled_slots(head, count));
+            for (size_t i = 0; i < n; ++i) {
+                T* value = element(head + i);
+                sink(*value);
+                std::destroy_at(value);
+            }
+            head_m.store(head + n, std::memory_order_release);
+            return n;
+        } else {
+            const auto [first, n] = claim(head_m, count, 1);
+            for (size_t i = 0; i < n; ++i) {
+                T* value = element(first + i);
+                sink(*value);
+                std::destroy_at(value);
+                // the slot is free again for the producer one lap later
+                slots_m[(first + i) & mask].sequence.store(first + i + N, std::memory_order_release);
+            }
+            return n;
+        }
+    }
+
+public:
+    using value_type = T;
+    static constexpr ring_mode mode = Mode;
+
+    my_ring () noexcept {
+        if constexpr (Mode == ring_mode::mpmc) {
+            for (size_t i = 0; i < N; ++i) {
+                slots_m[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+    }
+    my_ring (const my_ring&) = delete;
+    my_ring& operator=(const my_ring&) = delete;
+    // no other thread may use the ring meanwhile
+    ~my_ring() {
+        const size_t tail = tail_m.load(std::memory_order_acquire);
+        for (size_t position = head_m.load(std::memory_order_acquire); position != tail; ++position) {
+            std::destroy_at(element(position));
+        }
+    }
+
+    // single pushes; false when the ring is full
+    template <typename... Args>
+    bool try_emplace (Args&&... args) {
+        if constexpr (Mode == ring_mode::spsc) {
+            const size_t tail = tail_m.load(std::memory_order_relaxed);
+            if (free_slots(tail, 1) == 0) {
+                return false;
+            }
+            std::construct_at(element(tail), std::forward<Args>(args)...);
+            tail_m.store(tail + 1, std::memory_order_release);
+            return true;
+        } else {
+            // built before a slot is claimed, so a throwing constructor leaves the ring untouched
+            T value(std::forward<Args>(args)...);
+            return push_batch(std::make_move_iterator(&value), 1) == 1;
+        }
+    }
+    bool try_push (const T& value) {
+        return try_emplace(value);
+    }
+    bool try_push (T&& value) {
+        return try_emplace(std::move(value));
+    }
+
+    // pushes up to count elements from src, in order; returns how many fit
+    template <typename InputIt>
+    size_t push_n (InputIt src, const size_t count) {
+        return push_batch(src, count);
+    }
+
+    // single pops; false (or nullopt) when the ring is empty
+    bool try_pop (T& out) noexcept {
+        return pop_n(&out, 1) == 1;
+    }
+    std::optional<T> try_pop () noexcept {
+        std::optional<T> out;
+        pop_batch(1, [&](T& value) { out.emplace(std::move(value)); });
+        return out;
+    }
+
+    // moves up to count elements to out, in order; returns how many.
+    // Writing to out must not throw.
+    template <typename OutputIt>
+    size_t pop_n (OutputIt out, const size_t count) noexcept {
+        return pop_batch(count, [&](T& value) {
+            *out = std::move(value);
+            ++out;
+        });
+    }
+
+    // the number of elements at some recent moment; exact only while no
+    // other thread is pushing or popping
+    [[nodiscard]] size_t size_approx () const noexcept {
+        const size_t head = head_m.load(std::memory_order_acquire);
+        const size_t tail = tail_m.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+    [[nodiscard]] bool is_empty_approx () const noexcept {
+        return size_approx() == 0;
+    }
+    [[nodiscard]] static constexpr size_t capacity () noexcept {
+        return N;
+    }
+};
+
+#endif //MY_RING_H
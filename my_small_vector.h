@@ -0,0 +1,449 @@
+#ifndef MY_SMALL_VECTOR_H
+#define MY_SMALL_VECTOR_H
+
+#include "my_vector.h"
+#include "range_edit.h"
+
+// my_vector with room for N elements inside the object itself. The heap
+// is only touched once the size exceeds N; the API mirrors my_vector.
+template <typename T, size_t N, typename Growth = growth_factor_2>
+class my_small_vector {
+    static_assert(N > 0, "use my_vector for N == 0");
+
+    T* data_m;
+    size_t size_m;
+    size_t capacity_m;
+    alignas(T) unsigned char inline_m[N * sizeof(T)];
+
+    [[nodiscard]] T* inline_data () noexcept {
+        return reinterpret_cast<T*>(inline_m);
+    }
+    [[nodiscard]] bool owns_heap () const noexcept {
+        return data_m != reinterpret_cast<const T*>(inline_m);
+    }
+
+    [[nodiscard]] static T* allocate (const size_t n) {
+        return std::allocator<T>().allocate(n);
+    }
+    void release_heap () noexcept {
+        if (owns_heap()) {
+            std::allocator<T>().deallocate(data_m, capacity_m);
+        }
+    }
+
+    // see my_vector::transfer
+    static void transfer (T* src, const size_t n, T* dst) {
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            std::uninitialized_move_n(src, n, dst);
+        } else {
+            std::uninitialized_copy_n(src, n, dst);
+        }
+    }
+
+    // see my_vector::relocate
+    void relocate (T* dst, const size_t gap) {
+        if constexpr (is_trivially_relocatable_v<T>) {
+            if (gap != 0) {
+                std::memcpy(static_cast<void*>(dst), static_cast<const void*>(data_m), gap * sizeof(T));
+            }
+            if (gap != size_m) {
+                std::memcpy(static_cast<void*>(dst + gap + 1), static_cast<const void*>(data_m + gap),
+                            (size_m - gap) * sizeof(T));
+            }
+        } else {
+            transfer(data_m, gap, dst);
+            if (gap != size_m) {
+                try {
+                    transfer(data_m + gap, size_m - gap, dst + gap + 1);
+                } catch (...) {
+                    std::destroy_n(dst, gap);
+                    throw;
+                }
+            }
+            std::destroy_n(data_m, size_m);
+        }
+    }
+
+    // new_capacity <= N moves the elements back inline
+    void reallocate (const size_t new_capacity) {
+        T* new_data_m = new_capacity <= N ? inline_data() : allocate(new_capacity);
+        if (new_data_m == data_m) {
+            return;
+        }
+        try {
+            relocate(new_data_m, size_m);
+        } catch (...) {
+            if (new_data_m != inline_data()) {
+                std::allocator<T>().deallocate(new_data_m, new_capacity);
+            }
+            throw;
+        }
+        release_heap();
+        data_m = new_data_m;
+        capacity_m = new_capacity <= N ? N : new_capacity;
+    }
+
+    // only called when full, so the new block is always on the heap
+    template<typename... Args>
+    T* reallocate_emplace (const size_t index, Args&&... args) {
+        const size_t new_capacity = Growth::next_capacity(capacity_m, size_m + 1, sizeof(T));
+        T* new_data_m = allocate(new_capacity);
+        try {
+            std::construct_at(new_data_m + index, std::forward<Args>(args)...);
+        } catch (...) {
+            std::allocator<T>().deallocate(new_data_m, new_capacity);
+            throw;
+        }
+        try {
+            relocate(new_data_m, index);
+        } catch (...) {
+            std::destroy_at(new_data_m + index);
+            std::allocator<T>().deallocate(new_data_m, new_capacity);
+            throw;
+        }
+        release_heap();
+        data_m = new_data_m;
+        capacity_m = new_capacity;
+        ++size_m;
+        return data_m + index;
+    }
+
+    void grow_to_fit (const size_t required) {
+        if (required > capacity_m) {
+            reallocate(Growth::next_capacity(capacity_m, required, sizeof(T)));
+        }
+    }
+
+    static void construct_fill (T* dst, const size_t n, const T& value) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            fill_elements(dst, n, value);
+        } else {
+            std::uninitialized_fill_n(dst, n, value);
+        }
+    }
+
+    template<typename InputIt>
+    void assign_copy (InputIt src, const size_t n) {
+        grow_to_fit(n);
+        std::uninitialized_copy_n(src, n, data_m);
+        size_m = n;
+    }
+
+    // takes the elements of other, leaving it empty and inline
+    void take (my_small_vector& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (other.owns_heap()) {
+            data_m = other.data_m;
+            capacity_m = other.capacity_m;
+            size_m = other.size_m;
+        } else {
+            std::uninitialized_move_n(other.data_m, other.size_m, data_m);
+            std::destroy_n(other.data_m, other.size_m);
+            size_m = other.size_m;
+        }
+        other.data_m = other.inline_data();
+        other.capacity_m = N;
+        other.size_m = 0;
+    }
+
+public:
+    using value_type = T;
+
+    // constructors
+    my_small_vector () noexcept : data_m (inline_data()), size_m (0), capacity_m (N) {}
+    // the constructors below delegate to the default one, so once it has
+    // run the destructor cleans up after a throw: size_m only ever counts
+    // elements that were fully constructed
+    my_small_vector (const size_t n, const T& value) : my_small_vector () {
+        grow_to_fit(n);
+        construct_fill(data_m, n, value);
+        size_m = n;
+    }
+    my_small_vector (std::initializer_list<T> init) : my_small_vector () {
+        assign_copy(init.begin(), init.size());
+    }
+    template<typename InputIt, typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+    my_small_vector (InputIt first, InputIt last) : my_small_vector () {
+        using category = typename std::iterator_traits<InputIt>::iterator_category;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+            assign_copy(first, static_cast<size_t>(std::distance(first, last)));
+        } else {
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+        }
+    }
+
+    // copy
+    my_small_vector (const my_small_vector& other) : my_small_vector () {
+        assign_copy(other.data_m, other.size_m);
+    }
+    my_small_vector& operator=(const my_small_vector& other) {
+        if (this != &other) {
+            clear();
+            assign_copy(other.data_m, other.size_m);
+        }
+        return *this;
+    }
+
+    // move
+    my_small_vector (my_small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) : my_small_vector () {
+        take(other);
+    }
+    my_small_vector& operator=(my_small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            clear();
+            release_heap();
+            data_m = inline_data();
+            capacity_m = N;
+            take(other);
+        }
+        return *this;
+    }
+
+    // destructor
+    ~my_small_vector() {
+        std::destroy_n(data_m, size_m);
+        release_heap();
+    }
+
+    // access operators
+    T& operator[](size_t index) {
+        return data_m[index];
+    }
+    const T& operator[](size_t index) const {
+        return data_m[index];
+    }
+
+    T& at(size_t index) {
+        if (index >= size_m) {
+            throw std::out_of_range("Index out of range in at()");
+        }
+
+        return data_m[index];
+    }
+    const T& at(size_t index) const {
+        if (index >= size_m) {
+            throw std::out_of_range("Index out of range in at()");
+        }
+
+        return data_m[index];
+    }
+
+    T& back() {
+        if (size_m == 0) {
+            throw std::out_of_range("Accessing empty vector in back()");
+        }
+
+        return data_m[size_m - 1];
+    }
+    const T& back() const {
+        if (size_m == 0) {
+            throw std::out_of_range("Accessing empty vector in back()");
+        }
+
+        return data_m[size_m - 1];
+    }
+    T& front() {
+        if (size_m == 0) {
+            throw std::out_of_range("Accessing empty vector in front()");
+        }
+
+        return data_m[0];
+    }
+    const T& front() const {
+        if (size_m == 0) {
+            throw std::out_of_range("Accessing empty vector in front()");
+        }
+
+        return data_m[0];
+    }
+
+    // iterators
+    T* begin() {
+        return data_m;
+    }
+    T* end() {
+        return data_m + size_m;
+    }
+
+    const T* begin() const {
+        return data_m;
+    }
+    const T* end() const {
+        return data_m + size_m;
+    }
+
+    const T* cbegin() const {
+        return data_m;
+    }
+    const T* cend() const {
+        return data_m + size_m;
+    }
+
+    std::reverse_iterator<T*> rbegin() {
+        return std::reverse_iterator<T*>(end());
+    }
+    std::reverse_iterator<T*> rend() {
+        return std::reverse_iterator<T*>(begin());
+    }
+
+    std::reverse_iterator<const T*> rcbegin() const {
+        return std::reverse_iterator<const T*>(cend());
+    }
+    std::reverse_iterator<const T*> rcend() const {
+        return std::reverse_iterator<const T*>(cbegin());
+    }
+
+    // additional methods
+    [[nodiscard]] bool is_empty() const {
+        return size_m == 0;
+    }
+    [[nodiscard]] size_t size() const {
+        return size_m;
+    }
+    T* data() {
+        return data_m;
+    }
+    const T* data() const {
+        return data_m;
+    }
+    [[nodiscard]] bool is_inline() const {
+        return !owns_heap();
+    }
+    void reserve (size_t new_capacity) {
+        if (new_capacity > capacity_m) {
+            reallocate((new_capacity + 15) / 16 * 16);
+        }
+    }
+    [[nodiscard]] size_t capacity() const {
+        return capacity_m;
+    }
+    void shrink_to_fit () {
+        if (owns_heap() && capacity_m != size_m) {
+            reallocate(size_m);
+        }
+    }
+
+    // swap
+    void swap (my_small_vector& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (owns_heap() && other.owns_heap()) {
+            std::swap (data_m, other.data_m);
+            std::swap (size_m, other.size_m);
+            std::swap (capacity_m, other.capacity_m);
+            return;
+        }
+        // at least one side lives in its own inline buffer
+        my_small_vector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    // clear, resize
+    void clear () {
+        std::destroy_n(data_m, size_m);
+        size_m = 0;
+    }
+    void resize(const size_t new_size) {
+        if (new_size <= size_m) {
+            std::destroy(data_m + new_size, data_m + size_m);
+        } else {
+            grow_to_fit (new_size);
+            std::uninitialized_value_construct(data_m + size_m, data_m + new_size);
+        }
+        size_m = new_size;
+    }
+    void resize(size_t new_size, const T& value) {
+        if (new_size <= size_m) {
+            std::destroy(data_m + new_size, data_m + size_m);
+        } else if (new_size <= capacity_m) {
+            construct_fill(data_m + size_m, new_size - size_m, value);
+        } else {
+            // value may alias an element that is about to be relocated
+            T copy = value;
+            grow_to_fit (new_size);
+            construct_fill(data_m + size_m, new_size - size_m, copy);
+        }
+        size_m = new_size;
+    }
+
+    // inserts
+    T* insert(T* it, const T& value) {
+        return emplace(it, value);
+    }
+    T* insert(T* it, T&& value) {
+        return emplace(it, std::move(value));
+    }
+
+    template<typename InputIt>
+    T* insert(T* it, InputIt first, InputIt last) {
+        size_t index = it - data_m;
+        const size_t count = std::distance(first, last);
+        if (count == 0) {
+            return data_m + index;
+        }
+        grow_to_fit(size_m + count);
+        range_insert(default_range_storage(), data_m, size_m, index, first, count);
+        return data_m + index;
+    }
+
+    // erase
+    T* erase(T* pos) {
+        return erase(pos, pos + 1);
+    }
+    T* erase(T* first, T* last) {
+        const size_t start = first - data_m;
+        range_erase(default_range_storage(), data_m, size_m, start, static_cast<size_t>(last - first));
+        return data_m + start;
+    }
+
+    // pop, push, emplace
+    void pop_back() {
+        if (size_m > 0) {
+            std::destroy_at(data_m + --size_m);
+        }
+    }
+
+    void push_back(const T& value) {
+        emplace_back(value);
+    }
+    void push_back(T&& value) {
+        emplace_back(std::move(value));
+    }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (size_m == capacity_m) {
+            return *reallocate_emplace(size_m, std::forward<Args>(args)...);
+        }
+        std::construct_at(data_m + size_m, std::forward<Args>(args)...);
+        return data_m[size_m++];
+    }
+
+    template<typename... Args>
+    T* emplace(T* pos, Args&&... args) {
+        const size_t index = pos - data_m;
+        if (size_m == capacity_m) {
+            return reallocate_emplace(index, std::forward<Args>(args)...);
+        }
+        range_emplace(default_range_storage(), data_m, size_m, index, std::forward<Args>(args)...);
+        return data_m + index;
+    }
+
+    friend bool operator==(const my_small_vector& a, const my_small_vector& b) {
+        return a.size_m == b.size_m && elements_equal(a.data_m, b.data_m, a.size_m);
+    }
+
+    friend bool operator!=(const my_small_vector& a, const my_small_vector& b) {
+        return !(a == b);
+    }
+
+    // <, >, <= and >= are rewritten in terms of <=>, one pass per comparison
+    friend auto operator<=>(const my_small_vector& a, const my_small_vector& b) {
+        return elements_compare(a.data_m, a.size_m, b.data_m, b.size_m);
+    }
+
+};
+
+
+
+#endif //MY_SMALL_VECTOR_H
@@ -0,0 +1,436 @@
+#ifndef MY_SOA_VECTOR_H
+#define MY_SOA_VECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "growth_policy.h"
+#include "my_span.h"
+#include "relocation.h"
+
+// Structure-of-arrays vector: every field of the record lives in its own
+// buffer, so a scan over one or two fields only pulls those fields through
+// the cache. The buffers share one size and capacity and are aligned to a
+// cache line, which keeps the spans from field<I>() ready for aligned SIMD
+// loads.
+//
+// Whole records go in through push_back/emplace_back and come out as a
+// tuple of references (the proxy reference), by index or by iteration.
+template <typename... Fields>
+class my_soa_vector {
+    static_assert(sizeof...(Fields) > 0, "my_soa_vector needs at least one field");
+
+    using indices = std::index_sequence_for<Fields...>;
+    static constexpr size_t buffer_alignment = 64;
+    // bytes of one record across all buffers, fed to the growth policy
+    static constexpr size_t record_size = (sizeof(Fields) + ...);
+
+    std::tuple<Fields*...> data_m {};
+    size_t size_m = 0;
+    size_t capacity_m = 0;
+
+    template <size_t I>
+    using field_t = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+    template <typename F>
+    static F* allocate_field (const size_t n) {
+        return static_cast<F*>(::operator new(n * sizeof(F), std::align_val_t(std::max(buffer_alignment, alignof(F)))));
+    }
+    template <typename F>
+    static void deallocate_field (F* p) noexcept {
+        if (p != nullptr) {
+            ::operator delete(p, std::align_val_t(std::max(buffer_alignment, alignof(F))));
+        }
+    }
+
+    // moves (or copies, for a throwing move) n elements into raw storage
+    template <typename F>
+    static void transfer (F* src, const size_t n, F* dst) {
+        if constexpr (is_trivially_relocatable_v<F>) {
+            if (n != 0) {
+                std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(F));
+            }
+        } else if constexpr (std::is_nothrow_move_constructible_v<F> || !std::is_copy_constructible_v<F>) {
+            std::uninitialized_move_n(src, n, dst);
+        } else {
+            std::uninitialized_copy_n(src, n, dst);
+        }
+    }
+    // fields whose transfer may throw go first, while nothing has been
+    // moved out of the old buffers yet
+    template <typename F>
+    static constexpr bool may_throw_on_transfer_v =
+            !is_trivially_relocatable_v<F> && !std::is_nothrow_move_constructible_v<F>;
+
+    template <size_t... I>
+    void destroy_range (const size_t first, const size_t last, std::index_sequence<I...>) noexcept {
+        (std::destroy(std::get<I>(data_m) + first, std::get<I>(data_m) + last), ...);
+    }
+    template <size_t... I>
+    void free_buffers (std::index_sequence<I...>) noexcept {
+        (deallocate_field(std::get<I>(data_m)), ...);
+    }
+    void destroy_all () noexcept {
+        destroy_range(0, size_m, indices());
+        free_buffers(indices());
+        data_m = {};
+        size_m = 0;
+        capacity_m = 0;
+    }
+
+    // every buffer is allocated and every throwing transfer done before
+    // the first element is moved out, so a throw leaves *this untouched
+    template <size_t... I>
+    void reallocate (const size_t new_capacity, std::index_sequence<I...>) {
+        std::tuple<Fields*...> fresh {};
+        bool copied[sizeof...(Fields)] {};
+        try {
+            ((std::get<I>(fresh) = allocate_field<Fields>(new_capacity)), ...);
+            ((may_throw_on_transfer_v<Fields>
+                    ? (transfer(std::get<I>(data_m), size_m, std::get<I>(fresh)), copied[I] = true, void())
+                    : void()), ...);
+        } catch (...) {
+            ((copied[I] ? (void) std::destroy_n(std::get<I>(fresh), size_m) : void()), ...);
+            (deallocate_field(std::get<I>(fresh)), ...);
+            throw;
+        }
+        ((may_throw_on_transfer_v<Fields> ? void() : transfer(std::get<I>(data_m), size_m, std::get<I>(fresh))), ...);
+        ((is_trivially_relocatable_v<Fields> ? void() : (void) std::destroy_n(std::get<I>(data_m), size_m)), ...);
+        free_buffers(indices());
+        data_m = fresh;
+        capacity_m = new_capacity;
+    }
+
+    void grow_to_fit (const size_t required) {
+        if (required > capacity_m) {
+            reallocate(growth_factor_2::next_capacity(capacity_m, required, record_size), indices());
+        }
+    }
+
+    // constructs field I.. at index from the matching argument; if one
+    // throws the fields constructed before it are destroyed again
+    template <size_t... I, typename... Args>
+    void construct_at_index (const size_t index, std::index_sequence<I...>, Args&&... args) {
+        size_t done = 0;
+        try {
+            ((std::construct_at(std::get<I>(data_m) + index, std::forward<Args>(args)), ++done), ...);
+        } catch (...) {
+            ((I < done ? std::destroy_at(std::get<I>(data_m) + index) : void()), ...);
+            throw;
+        }
+    }
+
+    template <size_t... I>
+    void copy_from (const my_soa_vector& other, std::index_sequence<I...>) {
+        for (size_t i = 0; i < other.size_m; ++i) {
+            construct_at_index(i, indices(), std::get<I>(other.data_m)[i]...);
+            ++size_m;
+        }
+    }
+
+    template <size_t... I>
+    std::tuple<Fields&...> ref_at (const size_t index, std::index_sequence<I...>) noexcept {
+        return std::tuple<Fields&...>(std::get<I>(data_m)[index]...);
+    }
+    template <size_t... I>
+    std::tuple<const Fields&...> ref_at (const size_t index, std::index_sequence<I...>) const noexcept {
+        return std::tuple<const Fields&...>(std::get<I>(data_m)[index]...);
+    }
+
+    template <size_t... I>
+    bool fields_equal (const my_soa_vector& other, std::index_sequence<I...>) const {
+        return ((field<I>() == other.template field<I>()) && ...);
+    }
+
+public:
+    using value_type = std::tuple<Fields...>;
+    using reference = std::tuple<Fields&...>;
+    using const_reference = std::tuple<const Fields&...>;
+
+    // random access over proxy references; like a zip iterator it is only
+    // an input iterator to the legacy algorithms, whose contracts require
+    // real references. The const iterator claims no more than that to the
+    // ranges algorithms either: C++20 finds no common reference between
+    // tuple<const Fields&...> and tuple<Fields...>&, so it does not model
+    // std::random_access_iterator
+    template <bool Const>
+    class basic_iterator {
+        using owner = std::conditional_t<Const, const my_soa_vector, my_soa_vector>;
+
+        owner* vector_m = nullptr;
+        ptrdiff_t index_m = 0;
+
+    public:
+        using iterator_concept = std::conditional_t<Const, std::input_iterator_tag, std::random_access_iterator_tag>;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = my_soa_vector::value_type;
+        using difference_type = ptrdiff_t;
+        using reference = std::conditional_t<Const, const_reference, my_soa_vector::reference>;
+
+        basic_iterator () noexcept = default;
+        basic_iterator (owner* vector, const ptrdiff_t index) noexcept : vector_m(vector), index_m(index) {}
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        basic_iterator (const basic_iterator<false>& other) noexcept
+            : vector_m(other.owner_ptr()), index_m(other.index()) {}
+
+        reference operator*() const noexcept {
+            return (*vector_m)[static_cast<size_t>(index_m)];
+        }
+        reference operator[](const ptrdiff_t n) const noexcept {
+            return (*vector_m)[static_cast<size_t>(index_m + n)];
+        }
+
+        basic_iterator& operator++() noexcept {
+            ++index_m;
+            return *this;
+        }
+        basic_iterator operator++(int) noexcept {
+            basic_iterator old = *this;
+            ++index_m;
+            return old;
+        }
+        basic_iterator& operator--() noexcept {
+            --index_m;
+            return *this;
+        }
+        basic_iterator operator--(int) noexcept {
+            basic_iterator old = *this;
+            --index_m;
+            return old;
+        }
+        basic_iterator& operator+=(const ptrdiff_t n) noexcept {
+            index_m += n;
+            return *this;
+        }
+        basic_iterator& operator-=(const ptrdiff_t n) noexcept {
+            index_m -= n;
+            return *this;
+        }
+        friend basic_iterator operator+(basic_iterator it, const ptrdiff_t n) noexcept {
+            return it += n;
+        }
+        friend basic_iterator operator+(const ptrdiff_t n, basic_iterator it) noexcept {
+            return it += n;
+        }
+        friend basic_iterator operator-(basic_iterator it, const ptrdiff_t n) noexcept {
+            return it -= n;
+        }
+        friend ptrdiff_t operator-(const basic_iterator& a, const basic_iterator& b) noexcept {
+            return a.index_m - b.index_m;
+        }
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) noexcept {
+            return a.index_m == b.index_m;
+        }
+        friend auto operator<=>(const basic_iterator& a, const basic_iterator& b) noexcept {
+            return a.index_m <=> b.index_m;
+        }
+
+        [[nodiscard]] owner* owner_ptr () const noexcept {
+            return vector_m;
+        }
+        [[nodiscard]] ptrdiff_t index () const noexcept {
+            return index_m;
+        }
+    };
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    // constructors
+    my_soa_vector () noexcept = default;
+    my_soa_vector (const my_soa_vector& other) {
+        reserve(other.size_m);
+        try {
+            copy_from(other, indices());
+        } catch (...) {
+            destroy_all();
+            throw;
+        }
+    }
+    my_soa_vector (my_soa_vector&& other) noexcept
+        : data_m(std::exchange(other.data_m, {})),
+          size_m(std::exchange(other.size_m, 0)),
+          capacity_m(std::exchange(other.capacity_m, 0)) {}
+
+    my_soa_vector& operator=(const my_soa_vector& other) {
+        if (this != &other) {
+            my_soa_vector copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+    my_soa_vector& operator=(my_soa_vector&& other) noexcept {
+        if (this != &other) {
+            destroy_all();
+            data_m = std::exchange(other.data_m, {});
+            size_m = std::exchange(other.size_m, 0);
+            capacity_m = std::exchange(other.capacity_m, 0);
+        }
+        return *this;
+    }
+
+    ~my_soa_vector() {
+        destroy_all();
+    }
+
+    // access operators
+    reference operator[](const size_t index) noexcept {
+        return ref_at(index, indices());
+    }
+    const_reference operator[](const size_t index) const noexcept {
+        return ref_at(index, indices());
+    }
+    reference at(const size_t index) {
+        if (index >= size_m) {
+            throw std::out_of_range("Index out of range in at()");
+        }
+        return ref_at(index, indices());
+    }
+    const_reference at(const size_t index) const {
+        if (index >= size_m) {
+            throw std::out_of_range("Index out of range in at()");
+        }
+        return ref_at(index, indices());
+    }
+    reference front() {
+        if (size_m == 0) {
+            throw std::out_of_range("Accessing empty vector in front()");
+        }
+        return ref_at(0, indices());
+    }
+    const_reference front() const {
+        if (size_m == 0) {
+            throw std::out_of_range("Accessing empty vector in front()");
+        }
+        return ref_at(0, indices());
+    }
+    reference back() {
+        if (size_m == 0) {
+            throw std::out_of_range("Accessing empty vector in back()");
+        }
+        return ref_at(size_m - 1, indices());
+    }
+    const_reference back() const {
+        if (size_m == 0) {
+            throw std::out_of_range("Accessing empty vector in back()");
+        }
+        return ref_at(size_m - 1, indices());
+    }
+
+    // one field of every record, contiguous and cache-line aligned
+    template <size_t I>
+    my_span<field_t<I>> field() noexcept {
+        return my_span<field_t<I>>(std::get<I>(data_m), size_m);
+    }
+    template <size_t I>
+    my_span<const field_t<I>> field() const noexcept {
+        return my_span<const field_t<I>>(std::get<I>(data_m), size_m);
+    }
+
+    // iterators
+    iterator begin() noexcept {
+        return iterator(this, 0);
+    }
+    iterator end() noexcept {
+        return iterator(this, static_cast<ptrdiff_t>(size_m));
+    }
+    const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+    const_iterator end() const noexcept {
+        return const_iterator(this, static_cast<ptrdiff_t>(size_m));
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    // additional methods
+    [[nodiscard]] bool is_empty() const noexcept {
+        return size_m == 0;
+    }
+    [[nodiscard]] size_t size() const noexcept {
+        return size_m;
+    }
+    [[nodiscard]] size_t capacity() const noexcept {
+        return capacity_m;
+    }
+    void reserve (const size_t new_capacity) {
+        if (new_capacity > capacity_m) {
+            reallocate(new_capacity, indices());
+        }
+    }
+    void swap (my_soa_vector& other) noexcept {
+        std::swap(data_m, other.data_m);
+        std::swap(size_m, other.size_m);
+        std::swap(capacity_m, other.capacity_m);
+    }
+
+    // clear, resize
+    void clear () noexcept {
+        destroy_range(0, size_m, indices());
+        size_m = 0;
+    }
+    // new records are value-initialized field by field
+    void resize (const size_t new_size) {
+        if (new_size <= size_m) {
+            destroy_range(new_size, size_m, indices());
+            size_m = new_size;
+            return;
+        }
+        grow_to_fit(new_size);
+        while (size_m < new_size) {
+            construct_at_index(size_m, indices(), Fields()...);
+            ++size_m;
+        }
+    }
+
+    // pop, push, emplace
+    void pop_back () noexcept {
+        if (size_m > 0) {
+            --size_m;
+            destroy_range(size_m, size_m + 1, indices());
+        }
+    }
+
+    // one argument per field, each forwarded to that field's constructor
+    template <typename... Args>
+    reference emplace_back (Args&&... args) {
+        static_assert(sizeof...(Args) == sizeof...(Fields), "emplace_back takes one argument per field");
+        if (size_m == capacity_m) {
+            // the arguments may refer into the buffers that are about to move
+            value_type record(std::forward<Args>(args)...);
+            grow_to_fit(size_m + 1);
+            std::apply([this](auto&&... fields) {
+                construct_at_index(size_m, indices(), std::move(fields)...);
+            }, record);
+        } else {
+            construct_at_index(size_m, indices(), std::forward<Args>(args)...);
+        }
+        return ref_at(size_m++, indices());
+    }
+    reference push_back (const value_type& record) {
+        return std::apply([this](const auto&... fields) -> reference {
+            return emplace_back(fields...);
+        }, record);
+    }
+    reference push_back (value_type&& record) {
+        return std::apply([this](auto&... fields) -> reference {
+            return emplace_back(std::move(fields)...);
+        }, record);
+    }
+
+    friend bool operator==(const my_soa_vector& a, const my_soa_vector& b) {
+        return a.size_m == b.size_m && a.fields_equal(b, indices());
+    }
+};
+
+#endif //MY_SOA_VECTOR_H
@@ -0,0 +1,361 @@
+#ifndef MY_SPAN_H
+#define MY_SPAN_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include "simd_compare.h"
+
+// Non-owning views over the elements of my_vector, my_array or any other
+// container with data() and size(). Slicing is O(1) and never copies, so a
+// sub-range can be handed to the parallel algorithms, serialization or the
+// comparison operators instead of being copied into a new container.
+//
+// A view does not keep the container alive, and like a raw pointer it is
+// invalidated when the container reallocates.
+
+template <typename T>
+class my_strided_view;
+
+template <typename T>
+class my_span {
+    T* data_m = nullptr;
+    size_t size_m = 0;
+
+    template <typename Container>
+    using container_element_t = std::remove_pointer_t<decltype(std::declval<Container&>().data())>;
+
+    // T(*)[] conversion only allows adding const, not slicing a derived type
+    template <typename U>
+    static constexpr bool is_compatible_v = std::is_convertible_v<U (*)[], T (*)[]>;
+
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    // constructors
+    constexpr my_span () noexcept = default;
+    constexpr my_span (T* data, const size_t size) noexcept : data_m(data), size_m(size) {}
+    // a template, so my_span(ptr, 0) picks the size overload instead of
+    // being ambiguous with a null last pointer
+    template <typename Ptr, typename = std::enable_if_t<!std::is_integral_v<Ptr> && std::is_convertible_v<Ptr, T*>>>
+    constexpr my_span (Ptr first, Ptr last) noexcept : data_m(first), size_m(static_cast<size_t>(last - first)) {}
+
+    template <typename Container,
+              typename = std::enable_if_t<!std::is_same_v<std::remove_cvref_t<Container>, my_span>
+                                          && is_compatible_v<container_element_t<Container>>>>
+    constexpr my_span (Container& c) noexcept : data_m(c.data()), size_m(c.size()) {}
+
+    template <typename U, typename = std::enable_if_t<!std::is_same_v<U, T> && is_compatible_v<U>>>
+    constexpr my_span (const my_span<U>& other) noexcept : data_m(other.data()), size_m(other.size()) {}
+
+    // access operators
+    constexpr T& operator[](const size_t index) const {
+        return data_m[index];
+    }
+    constexpr T& at(const size_t index) const {
+        if (index >= size_m) {
+            throw std::out_of_range("Index out of range in at()");
+        }
+        return data_m[index];
+    }
+    constexpr T& front() const {
+        if (size_m == 0) {
+            throw std::out_of_range("Accessing empty span in front()");
+        }
+        return data_m[0];
+    }
+    constexpr T& back() const {
+        if (size_m == 0) {
+            throw std::out_of_range("Accessing empty span in back()");
+        }
+        return data_m[size_m - 1];
+    }
+
+    // iterators
+    constexpr T* begin() const noexcept {
+        return data_m;
+    }
+    constexpr T* end() const noexcept {
+        return data_m + size_m;
+    }
+    constexpr const T* cbegin() const noexcept {
+        return data_m;
+    }
+    constexpr const T* cend() const noexcept {
+        return data_m + size_m;
+    }
+    constexpr std::reverse_iterator<T*> rbegin() const noexcept {
+        return std::reverse_iterator<T*>(end());
+    }
+    constexpr std::reverse_iterator<T*> rend() const noexcept {
+        return std::reverse_iterator<T*>(begin());
+    }
+
+    // additional methods
+    [[nodiscard]] constexpr bool is_empty() const noexcept {
+        return size_m == 0;
+    }
+    [[nodiscard]] constexpr size_t size() const noexcept {
+        return size_m;
+    }
+    [[nodiscard]] constexpr size_t size_bytes() const noexcept {
+        return size_m * sizeof(T);
+    }
+    constexpr T* data() const noexcept {
+        return data_m;
+    }
+
+    // slicing
+    constexpr my_span first (const size_t count) const {
+        if (count > size_m) {
+            throw std::out_of_range("Count out of range in first()");
+        }
+        return my_span(data_m, count);
+    }
+    constexpr my_span last (const size_t count) const {
+        if (count > size_m) {
+            throw std::out_of_range("Count out of range in last()");
+        }
+        return my_span(data_m + (size_m - count), count);
+    }
+    // count == npos takes everything after offset
+    constexpr my_span subspan (const size_t offset, const size_t count = npos) const {
+        if (offset > size_m || (count != npos && count > size_m - offset)) {
+            throw std::out_of_range("Range out of bounds in subspan()");
+        }
+        return my_span(data_m + offset, count == npos ? size_m - offset : count);
+    }
+    // every step-th element, starting with the first
+    constexpr my_strided_view<T> stride (const size_t step) const {
+        return my_strided_view<T>(data_m, size_m, 1).stride(step);
+    }
+
+    // comparisons with views of the same element type, const or not, and
+    // with the containers they convert from; the reversed forms come from
+    // the C++20 rewrite rules
+    friend constexpr bool operator==(const my_span& a, const my_span<const value_type>& b) {
+        return a.size() == b.size() && elements_equal<value_type>(a.data(), b.data(), a.size());
+    }
+    friend constexpr auto operator<=>(const my_span& a, const my_span<const value_type>& b) {
+        return elements_compare<value_type>(a.data(), a.size(), b.data(), b.size());
+    }
+};
+
+template <typename Container>
+my_span (Container&) -> my_span<std::remove_pointer_t<decltype(std::declval<Container&>().data())>>;
+
+// View of every stride-th element of a contiguous range. The stride is
+// counted in elements and may be negative, so a reversed view is a view
+// too.
+template <typename T>
+class my_strided_view {
+    T* data_m = nullptr;
+    size_t size_m = 0;
+    ptrdiff_t stride_m = 1;
+
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+
+    // keeps the base pointer and an index, so that stepping past the end
+    // never forms a pointer outside the underlying array
+    class iterator {
+        T* base_m = nullptr;
+        ptrdiff_t index_m = 0;
+        ptrdiff_t stride_m = 1;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::remove_cv_t<T>;
+        using difference_type = ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        constexpr iterator () noexcept = default;
+        constexpr iterator (T* base, const ptrdiff_t index, const ptrdiff_t stride) noexcept
+            : base_m(base), index_m(index), stride_m(stride) {}
+
+        constexpr T& operator*() const noexcept {
+            return base_m[index_m * stride_m];
+        }
+        constexpr T* operator->() const noexcept {
+            return base_m + index_m * stride_m;
+        }
+        constexpr T& operator[](const ptrdiff_t n) const noexcept {
+            return base_m[(index_m + n) * stride_m];
+        }
+
+        constexpr iterator& operator++() noexcept {
+            ++index_m;
+            return *this;
+        }
+        constexpr iterator operator++(int) noexcept {
+            iterator old = *this;
+            ++index_m;
+            return old;
+        }
+        constexpr iterator& operator--() noexcept {
+            --index_m;
+            return *this;
+        }
+        constexpr iterator operator--(int) noexcept {
+            iterator old = *this;
+            --index_m;
+            return old;
+        }
+        constexpr iterator& operator+=(const ptrdiff_t n) noexcept {
+            index_m += n;
+            return *this;
+        }
+        constexpr iterator& operator-=(const ptrdiff_t n) noexcept {
+            index_m -= n;
+            return *this;
+        }
+        friend constexpr iterator operator+(iterator it, const ptrdiff_t n) noexcept {
+            return it += n;
+        }
+        friend constexpr iterator operator+(const ptrdiff_t n, iterator it) noexcept {
+            return it += n;
+        }
+        friend constexpr iterator operator-(iterator it, const ptrdiff_t n) noexcept {
+            return it -= n;
+        }
+        friend constexpr ptrdiff_t operator-(const iterator& a, const iterator& b) noexcept {
+            return a.index_m - b.index_m;
+        }
+
+        friend constexpr bool operator==(const iterator& a, const iterator& b) noexcept {
+            return a.index_m == b.index_m;
+        }
+        friend constexpr auto operator<=>(const iterator& a, const iterator& b) noexcept {
+            return a.index_m <=> b.index_m;
+        }
+    };
+
+    // constructors
+    constexpr my_strided_view () noexcept = default;
+    // size elements at data, data + stride, data + 2 * stride, ...
+    constexpr my_strided_view (T* data, const size_t size, const ptrdiff_t stride) noexcept
+        : data_m(data), size_m(size), stride_m(stride) {}
+
+    template <typename U, typename = std::enable_if_t<!std::is_same_v<U, T> && std::is_convertible_v<U (*)[], T (*)[]>>>
+    constexpr my_strided_view (const my_strided_view<U>& other) noexcept
+        : data_m(other.size() == 0 ? nullptr : &other[0]), size_m(other.size()), stride_m(other.stride()) {}
+
+    // access operators
+    constexpr T& operator[](const size_t index) const {
+        return data_m[static_cast<ptrdiff_t>(index) * stride_m];
+    }
+    constexpr T& at(const size_t index) const {
+        if (index >= size_m) {
+            throw std::out_of_range("Index out of range in at()");
+        }
+        return (*this)[index];
+    }
+    constexpr T& front() const {
+        if (size_m == 0) {
+            throw std::out_of_range("Accessing empty view in front()");
+        }
+        return (*this)[0];
+    }
+    constexpr T& back() const {
+        if (size_m == 0) {
+            throw std::out_of_range("Accessing empty view in back()");
+        }
+        return (*this)[size_m - 1];
+    }
+
+    // iterators
+    constexpr iterator begin() const noexcept {
+        return iterator(data_m, 0, stride_m);
+    }
+    constexpr iterator end() const noexcept {
+        return iterator(data_m, static_cast<ptrdiff_t>(size_m), stride_m);
+    }
+    constexpr std::reverse_iterator<iterator> rbegin() const noexcept {
+        return std::reverse_iterator<iterator>(end());
+    }
+    constexpr std::reverse_iterator<iterator> rend() const noexcept {
+        return std::reverse_iterator<iterator>(begin());
+    }
+
+    // additional methods
+    [[nodiscard]] constexpr bool is_empty() const noexcept {
+        return size_m == 0;
+    }
+    [[nodiscard]] constexpr size_t size() const noexcept {
+        return size_m;
+    }
+    [[nodiscard]] constexpr ptrdiff_t stride() const noexcept {
+        return stride_m;
+    }
+    // the view as a my_span; only valid when stride() == 1
+    constexpr my_span<T> contiguous () const {
+        if (stride_m != 1) {
+            throw std::logic_error("Strided view is not contiguous in contiguous()");
+        }
+        return my_span<T>(data_m, size_m);
+    }
+
+    // slicing
+    constexpr my_strided_view first (const size_t count) const {
+        if (count > size_m) {
+            throw std::out_of_range("Count out of range in first()");
+        }
+        return my_strided_view(data_m, count, stride_m);
+    }
+    constexpr my_strided_view last (const size_t count) const {
+        if (count > size_m) {
+            throw std::out_of_range("Count out of range in last()");
+        }
+        return subspan(size_m - count, count);
+    }
+    constexpr my_strided_view subspan (const size_t offset, const size_t count = my_span<T>::npos) const {
+        if (offset > size_m || (count != my_span<T>::npos && count > size_m - offset)) {
+            throw std::out_of_range("Range out of bounds in subspan()");
+        }
+        const size_t n = count == my_span<T>::npos ? size_m - offset : count;
+        return my_strided_view(n == 0 ? data_m : &(*this)[offset], n, stride_m);
+    }
+    // every step-th element of this view
+    constexpr my_strided_view stride (const size_t step) const {
+        if (step == 0) {
+            throw std::out_of_range("Stride must be positive in stride()");
+        }
+        const size_t count = size_m == 0 ? 0 : (size_m - 1) / step + 1;
+        // with two or more elements left, step * stride spans less than this
+        // view already does, so the product fits; with fewer it is never
+        // used, and step itself may not even fit in a ptrdiff_t
+        return my_strided_view(data_m, count, count < 2 ? stride_m : stride_m * static_cast<ptrdiff_t>(step));
+    }
+    // the same elements in the opposite order
+    constexpr my_strided_view reversed () const noexcept {
+        if (size_m == 0) {
+            return *this;
+        }
+        return my_strided_view(&(*this)[size_m - 1], size_m, -stride_m);
+    }
+
+    // comparisons; a unit-stride view compares its memory directly
+    friend constexpr bool operator==(const my_strided_view& a, const my_strided_view<const value_type>& b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        if (a.stride() == 1 && b.stride() == 1 && a.size() != 0) {
+            return elements_equal<value_type>(&a[0], &b[0], a.size());
+        }
+        return std::equal(a.begin(), a.end(), b.begin());
+    }
+    friend constexpr auto operator<=>(const my_strided_view& a, const my_strided_view<const value_type>& b) {
+        if (a.stride() == 1 && b.stride() == 1 && a.size() != 0 && b.size() != 0) {
+            return elements_compare<value_type>(&a[0], a.size(), &b[0], b.size());
+        }
+        return std::lexicographical_compare_three_way(a.begin(), a.end(), b.begin(), b.end(), synth_three_way());
+    }
+};
+
+#endif //MY_SPAN_H
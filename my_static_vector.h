@@ -0,0 +1,367 @@
+#ifndef MY_STATIC_VECTOR_H
+#define MY_STATIC_VECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "range_edit.h"
+#include "relocation.h"
+#include "simd_compare.h"
+#include "simd_fill.h"
+
+// What my_static_vector does when an operation would exceed its capacity:
+// checked throws std::length_error and leaves the vector unchanged,
+// unchecked skips the test, so overflowing it is undefined behaviour.
+enum class static_vector_overflow {
+    checked,
+    unchecked
+};
+
+// Vector with a fixed capacity of N elements stored inside the object,
+// for scratch buffers on hot paths that must never touch the heap. Unlike
+// my_array it has a live size: only [0, size()) holds constructed
+// elements. The API mirrors my_vector, without the growth-related calls.
+template <typename T, size_t N, static_vector_overflow Overflow = static_vector_overflow::checked>
+class my_static_vector {
+    static_assert(N > 0, "my_static_vector needs a capacity");
+
+    size_t size_m = 0;
+    alignas(T) unsigned char storage_m[N * sizeof(T)];
+
+    [[nodiscard]] T* elements () noexcept {
+        return reinterpret_cast<T*>(storage_m);
+    }
+    [[nodiscard]] const T* elements () const noexcept {
+        return reinterpret_cast<const T*>(storage_m);
+    }
+
+    // throws unless count more elements fit
+    void check_room (const size_t count, const char* message) const {
+        if constexpr (Overflow == static_vector_overflow::checked) {
+            if (count > N - size_m) {
+                throw std::length_error(message);
+            }
+        }
+    }
+
+    static void construct_fill (T* dst, const size_t n, const T& value) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            fill_elements(dst, n, value);
+        } else {
+            std::uninitialized_fill_n(dst, n, value);
+        }
+    }
+
+    template<typename InputIt>
+    void assign_copy (InputIt src, const size_t n) {
+        check_room(n, "Capacity exceeded in my_static_vector()");
+        std::uninitialized_copy_n(src, n, elements());
+        size_m = n;
+    }
+
+    // moves the elements of other here and leaves it empty
+    void take (my_static_vector& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        std::uninitialized_move_n(other.elements(), other.size_m, elements());
+        size_m = other.size_m;
+        other.clear();
+    }
+
+public:
+    using value_type = T;
+    static constexpr static_vector_overflow overflow = Overflow;
+
+    // constructors
+    my_static_vector () noexcept {}
+    my_static_vector (const size_t n, const T& value) {
+        check_room(n, "Capacity exceeded in my_static_vector()");
+        construct_fill(elements(), n, value);
+        size_m = n;
+    }
+    my_static_vector (std::initializer_list<T> init) {
+        assign_copy(init.begin(), init.size());
+    }
+    template<typename InputIt, typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+    my_static_vector (InputIt first, InputIt last) {
+        using category = typename std::iterator_traits<InputIt>::iterator_category;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+            assign_copy(first, static_cast<size_t>(std::distance(first, last)));
+        } else {
+            try {
+                for (; first != last; ++first) {
+                    emplace_back(*first);
+                }
+            } catch (...) {
+                clear();
+                throw;
+            }
+        }
+    }
+
+    // copy
+    my_static_vector (const my_static_vector& other) {
+        assign_copy(other.elements(), other.size_m);
+    }
+    my_static_vector& operator=(const my_static_vector& other) {
+        if (this != &other) {
+            clear();
+            assign_copy(other.elements(), other.size_m);
+        }
+        return *this;
+    }
+
+    // move: the elements are moved one by one, the source ends up empty
+    my_static_vector (my_static_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        take(other);
+    }
+    my_static_vector& operator=(my_static_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            clear();
+            take(other);
+        }
+        return *this;
+    }
+
+    // destructor
+    ~my_static_vector() requires std::is_trivially_destructible_v<T> = default;
+    ~my_static_vector() {
+        std::destroy_n(elements(), size_m);
+    }
+
+    // access operators
+    T& operator[](size_t index) {
+        return elements()[index];
+    }
+    const T& operator[](size_t index) const {
+        return elements()[index];
+    }
+
+    T& at(size_t index) {
+        if (index >= size_m) {
+            throw std::out_of_range("Index out of range in at()");
+        }
+
+        return elements()[index];
+    }
+    const T& at(size_t index) const {
+        if (index >= size_m) {
+            throw std::out_of_range("Index out of range in at()");
+        }
+
+        return elements()[index];
+    }
+
+    T& back() {
+        if (size_m == 0) {
+            throw std::out_of_range("Accessing empty vector in back()");
+        }
+
+        return elements()[size_m - 1];
+    }
+    const T& back() const {
+        if (size_m == 0) {
+            throw std::out_of_range("Accessing empty vector in back()");
+        }
+
+        return elements()[size_m - 1];
+    }
+    T& front() {
+        if (size_m == 0) {
+            throw std::out_of_range("Accessing empty vector in front()");
+        }
+
+        return elements()[0];
+    }
+    const T& front() const {
+        if (size_m == 0) {
+            throw std::out_of_range("Accessing empty vector in front()");
+        }
+
+        return elements()[0];
+    }
+
+    // iterators
+    T* begin() {
+        return elements();
+    }
+    T* end() {
+        return elements() + size_m;
+    }
+
+    const T* begin() const {
+        return elements();
+    }
+    const T* end() const {
+        return elements() + size_m;
+    }
+
+    const T* cbegin() const {
+        return elements();
+    }
+    const T* cend() const {
+        return elements() + size_m;
+    }
+
+    std::reverse_iterator<T*> rbegin() {
+        return std::reverse_iterator<T*>(end());
+    }
+    std::reverse_iterator<T*> rend() {
+        return std::reverse_iterator<T*>(begin());
+    }
+
+    std::reverse_iterator<const T*> rcbegin() const {
+        return std::reverse_iterator<const T*>(cend());
+    }
+    std::reverse_iterator<const T*> rcend() const {
+        return std::reverse_iterator<const T*>(cbegin());
+    }
+
+    // additional methods
+    [[nodiscard]] bool is_empty() const {
+        return size_m == 0;
+    }
+    [[nodiscard]] bool is_full() const {
+        return size_m == N;
+    }
+    [[nodiscard]] size_t size() const {
+        return size_m;
+    }
+    [[nodiscard]] static constexpr size_t capacity() {
+        return N;
+    }
+    T* data() {
+        return elements();
+    }
+    const T* data() const {
+        return elements();
+    }
+
+    // swap: the shared prefix is swapped in place, the longer tail moved over
+    void swap (my_static_vector& other) noexcept(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_swappable_v<T>) {
+        my_static_vector& longer = size_m >= other.size_m ? *this : other;
+        my_static_vector& shorter = size_m >= other.size_m ? other : *this;
+        const size_t common = shorter.size_m;
+        std::swap_ranges(longer.elements(), longer.elements() + common, shorter.elements());
+        std::uninitialized_move(longer.elements() + common, longer.elements() + longer.size_m, shorter.elements() + common);
+        std::destroy(longer.elements() + common, longer.elements() + longer.size_m);
+        std::swap(size_m, other.size_m);
+    }
+
+    // clear, resize
+    void clear () {
+        std::destroy_n(elements(), size_m);
+        size_m = 0;
+    }
+    void resize(const size_t new_size) {
+        if (new_size <= size_m) {
+            std::destroy(elements() + new_size, elements() + size_m);
+        } else {
+            check_room(new_size - size_m, "Capacity exceeded in resize()");
+            std::uninitialized_value_construct(elements() + size_m, elements() + new_size);
+        }
+        size_m = new_size;
+    }
+    void resize(size_t new_size, const T& value) {
+        if (new_size <= size_m) {
+            std::destroy(elements() + new_size, elements() + size_m);
+        } else {
+            check_room(new_size - size_m, "Capacity exceeded in resize()");
+            construct_fill(elements() + size_m, new_size - size_m, value);
+        }
+        size_m = new_size;
+    }
+
+    // inserts
+    T* insert(T* it, const T& value) {
+        return emplace(it, value);
+    }
+    T* insert(T* it, T&& value) {
+        return emplace(it, std::move(value));
+    }
+
+    template<typename InputIt>
+    T* insert(T* it, InputIt first, InputIt last) {
+        size_t index = it - elements();
+        const size_t count = std::distance(first, last);
+        if (count == 0) {
+            return elements() + index;
+        }
+        check_room(count, "Capacity exceeded in insert()");
+        range_insert(default_range_storage(), elements(), size_m, index, first, count);
+        return elements() + index;
+    }
+
+    // erase
+    T* erase(T* pos) {
+        return erase(pos, pos + 1);
+    }
+    T* erase(T* first, T* last) {
+        const size_t start = first - elements();
+        range_erase(default_range_storage(), elements(), size_m, start, static_cast<size_t>(last - first));
+        return elements() + start;
+    }
+
+    // pop, push, emplace
+    void pop_back() {
+        if (size_m > 0) {
+            std::destroy_at(elements() + --size_m);
+        }
+    }
+
+    void push_back(const T& value) {
+        emplace_back(value);
+    }
+    void push_back(T&& value) {
+        emplace_back(std::move(value));
+    }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        check_room(1, "Capacity exceeded in emplace_back()");
+        std::construct_at(elements() + size_m, std::forward<Args>(args)...);
+        return elements()[size_m++];
+    }
+    // emplace_back that reports a full vector with nullptr, whatever the
+    // overflow mode
+    template<typename... Args>
+    T* try_emplace_back(Args&&... args) {
+        if (size_m == N) {
+            return nullptr;
+        }
+        std::construct_at(elements() + size_m, std::forward<Args>(args)...);
+        return elements() + size_m++;
+    }
+
+    template<typename... Args>
+    T* emplace(T* pos, Args&&... args) {
+        const size_t index = pos - elements();
+        check_room(1, "Capacity exceeded in emplace()");
+        range_emplace(default_range_storage(), elements(), size_m, index, std::forward<Args>(args)...);
+        return elements() + index;
+    }
+
+    friend bool operator==(const my_static_vector& a, const my_static_vector& b) {
+        return a.size_m == b.size_m && elements_equal(a.elements(), b.elements(), a.size_m);
+    }
+
+    friend bool operator!=(const my_static_vector& a, const my_static_vector& b) {
+        return !(a == b);
+    }
+
+    // <, >, <= and >= are rewritten in terms of <=>, one pass per comparison
+    friend auto operator<=>(const my_static_vector& a, const my_static_vector& b) {
+        return elements_compare(a.elements(), a.size_m, b.elements(), b.size_m);
+    }
+
+};
+
+template <typename T, size_t N>
+using my_unchecked_static_vector = my_static_vector<T, N, static_vector_overflow::unchecked>;
+
+
+
+#endif //MY_STATIC_VECTOR_H
@@ -1,79 +1,457 @@
 #ifndef MY_VECTOR_H
 #define MY_VECTOR_H
+#include <algorithm>
+#include <concepts>
+#include <cstring>
 #include <iterator>
-
-
-template <typename T>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include "aligned_allocator.h"
+#include "growth_policy.h"
+#include "range_edit.h"
+#include "relocation.h"
+#include "simd_compare.h"
+#include "simd_fill.h"
+#include "vector_stats.h"
+
+template <typename T, typename Growth = growth_factor_2, typename Alloc = std::allocator<T>>
 class my_vector {
+    using alloc_traits = std::allocator_traits<Alloc>;
+    static_assert(std::is_same_v<typename alloc_traits::value_type, T>, "Alloc::value_type must be T");
+    static_assert(std::is_same_v<typename alloc_traits::pointer, T*>, "fancy pointers are not supported");
+
     T* data_m;
     size_t size_m;
     size_t capacity_m;
+    [[no_unique_address]] Alloc alloc_m;
+
+    using stats = vector_stats<my_vector>;
 
     [[nodiscard]] static size_t align_to_16 (const size_t num) {
         return (num + 15) / 16 * 16;
     }
+    [[nodiscard]] static size_t pad_to_lanes (const size_t num) {
+        return round_up_to(num, lane_elements);
+    }
+
+    // capacity to allocate when size must reach at least required
+    [[nodiscard]] size_t grown_capacity (const size_t required) const {
+        return pad_to_lanes(Growth::next_capacity(capacity_m, required, sizeof(T)));
+    }
+    void grow_to_fit (const size_t required) {
+        if (required > capacity_m) {
+            reallocate(grown_capacity(required));
+        }
+    }
+
+    // grows the block in place when the allocator has an expand() hook
+    // (huge_page_allocator, arena and pool allocators); nothing moves, so
+    // this works for any T
+    [[nodiscard]] bool try_expand (const size_t new_capacity) {
+        if constexpr (requires (Alloc& a, T* p, size_t n) { { a.expand(p, n, n) } -> std::same_as<bool>; }) {
+            if (data_m != nullptr && alloc_m.expand(data_m, capacity_m, new_capacity)) {
+                if constexpr (vector_stats_enabled) {
+                    stats::on_expansion(new_capacity);
+                }
+                capacity_m = new_capacity;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // the allocator can move a block's bytes itself (realloc, mremap),
+    // which is only a valid way to move trivially relocatable elements
+    static constexpr bool allocator_relocates = is_trivially_relocatable_v<T>
+            && requires (Alloc& a, T* p, size_t n) { { a.reallocate(p, n, n) } -> std::same_as<T*>; };
+
+    // resizes the block through the allocator's reallocate() hook; false
+    // when there is none or it declines, with the block left as it was
+    [[nodiscard]] bool try_reallocate (const size_t new_capacity) {
+        if constexpr (allocator_relocates) {
+            if (data_m != nullptr && new_capacity != 0) {
+                if (T* moved = alloc_m.reallocate(data_m, capacity_m, new_capacity)) {
+                    if constexpr (vector_stats_enabled) {
+                        stats::on_allocation(new_capacity, new_capacity * sizeof(T));
+                        stats::on_reallocation();
+                    }
+                    data_m = moved;
+                    capacity_m = new_capacity;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
 
-    void allocate_and_copy (const T* src, const size_t data_size) {
+    // construct() is a plain byte copy for trivially copyable types,
+    // unless the allocator customizes it
+    static constexpr bool bytewise_construct = std::is_trivially_copyable_v<T>
+            && (std::is_same_v<Alloc, std::pmr::polymorphic_allocator<T>>
+                || !requires (Alloc& a, T* p, const T& v) { a.construct(p, v); });
+
+    // raw storage: only [0, size_m) holds constructed objects
+    [[nodiscard]] T* allocate (const size_t n) {
+        if (n == 0) {
+            return nullptr;
+        }
+        if constexpr (vector_stats_enabled) {
+            stats::on_allocation(n, n * sizeof(T));
+        }
+        return alloc_traits::allocate(alloc_m, n);
+    }
+    void deallocate (T* p, const size_t n) noexcept {
+        if (p != nullptr) {
+            alloc_traits::deallocate(alloc_m, p, n);
+        }
+    }
+    template<typename... Args>
+    void construct (T* p, Args&&... args) {
+        alloc_traits::construct(alloc_m, p, std::forward<Args>(args)...);
+    }
+    void destroy (T* first, T* last) noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (; first != last; ++first) {
+                alloc_traits::destroy(alloc_m, first);
+            }
+        }
+    }
+    // range_edit.h storage that constructs through the allocator
+    struct allocator_storage {
+        my_vector& v;
+        template<typename... Args>
+        void construct (T* p, Args&&... args) {
+            v.construct(p, std::forward<Args>(args)...);
+        }
+        void destroy (T* first, T* last) noexcept {
+            v.destroy(first, last);
+        }
+    };
+
+    void destroy_all () noexcept {
+        destroy(data_m, data_m + size_m);
+        deallocate(data_m, capacity_m);
+    }
+
+    // construct n elements at dst from src, undoing the partial work on throw
+    template<typename InputIt>
+    InputIt construct_copy (InputIt src, const size_t n, T* dst) {
+        size_t i = 0;
+        try {
+            for (; i < n; ++i, ++src) {
+                construct(dst + i, *src);
+            }
+        } catch (...) {
+            destroy(dst, dst + i);
+            throw;
+        }
+        return src;
+    }
+    void construct_fill (T* dst, const size_t n, const T& value) {
+        if constexpr (bytewise_construct) {
+            fill_elements(dst, n, value);
+            return;
+        }
+        size_t i = 0;
+        try {
+            for (; i < n; ++i) {
+                construct(dst + i, value);
+            }
+        } catch (...) {
+            destroy(dst, dst + i);
+            throw;
+        }
+    }
+    void construct_default (T* dst, const size_t n) {
+        if constexpr (bytewise_construct && (std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>)) {
+            // value-initialization of these is all-zero bytes
+            if (n != 0) {
+                std::memset(static_cast<void*>(dst), 0, n * sizeof(T));
+            }
+            return;
+        }
+        size_t i = 0;
+        try {
+            for (; i < n; ++i) {
+                construct(dst + i);
+            }
+        } catch (...) {
+            destroy(dst, dst + i);
+            throw;
+        }
+    }
+    void construct_move (T* src, const size_t n, T* dst) {
+        construct_copy(std::make_move_iterator(src), n, dst);
+    }
+
+    template<typename InputIt>
+    void allocate_and_copy (InputIt src, const size_t data_size) {
+        capacity_m = grown_capacity (data_size);
+        data_m = allocate(capacity_m);
+        try {
+            construct_copy(src, data_size, data_m);
+        } catch (...) {
+            deallocate(data_m, capacity_m);
+            data_m = nullptr;
+            capacity_m = 0;
+            throw;
+        }
         size_m = data_size;
-        capacity_m = align_to_16 (data_size);
-        data_m = new T[capacity_m];
-        for (size_t i = 0; i < size_m; i++) {
-            data_m[i] = src[i];
+    }
+
+    // constructs n elements at dst from src, moving unless a throwing move
+    // would lose the strong guarantee
+    void transfer (T* src, const size_t n, T* dst) {
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            construct_move(src, n, dst);
+        } else {
+            construct_copy(src, n, dst);
+        }
+    }
+
+    // moves [0, size_m) into dst, leaving the slot dst[gap] unconstructed;
+    // gap == size_m is a plain move of the whole range
+    void relocate (T* dst, const size_t gap) {
+        if constexpr (vector_stats_enabled) {
+            if (capacity_m != 0) {
+                stats::on_reallocation();
+            }
+            if constexpr (is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>
+                          || !std::is_copy_constructible_v<T>) {
+                stats::on_move(size_m * sizeof(T));
+            } else {
+                stats::on_copy(size_m * sizeof(T));
+            }
+        }
+        if constexpr (is_trivially_relocatable_v<T>) {
+            if (gap != 0) {
+                std::memcpy(static_cast<void*>(dst), static_cast<const void*>(data_m), gap * sizeof(T));
+            }
+            if (gap != size_m) {
+                std::memcpy(static_cast<void*>(dst + gap + 1), static_cast<const void*>(data_m + gap),
+                            (size_m - gap) * sizeof(T));
+            }
+        } else {
+            transfer(data_m, gap, dst);
+            if (gap != size_m) {
+                try {
+                    transfer(data_m + gap, size_m - gap, dst + gap + 1);
+                } catch (...) {
+                    destroy(dst, dst + gap);
+                    throw;
+                }
+            }
+            destroy(data_m, data_m + size_m);
+        }
+    }
+
+    // rebuilds the live elements in a fresh block of new_capacity slots
+    void reallocate (const size_t new_capacity) {
+        if ((new_capacity > capacity_m && try_expand(new_capacity)) || try_reallocate(new_capacity)) {
+            return;
+        }
+        T* new_data_m = allocate(new_capacity);
+        try {
+            relocate(new_data_m, size_m);
+        } catch (...) {
+            deallocate(new_data_m, new_capacity);
+            throw;
         }
+        deallocate(data_m, capacity_m);
+        data_m = new_data_m;
+        capacity_m = new_capacity;
+    }
+
+    // grows and constructs the new element straight into its final slot
+    // of the new block; args may still refer to the old elements
+    template<typename... Args>
+    T* reallocate_emplace (const size_t index, Args&&... args) {
+        const size_t new_capacity = grown_capacity(size_m + 1);
+        if constexpr (allocator_relocates && std::is_nothrow_move_constructible_v<T>) {
+            // args may refer to an element, so the new one is built before
+            // the block moves
+            T tmp(std::forward<Args>(args)...);
+            if (try_reallocate(new_capacity)) {
+                std::memmove(static_cast<void*>(data_m + index + 1), static_cast<const void*>(data_m + index),
+                             (size_m - index) * sizeof(T));
+                construct(data_m + index, std::move(tmp));
+                ++size_m;
+                return data_m + index;
+            }
+            return reallocate_emplace_slow(new_capacity, index, std::move(tmp));
+        } else {
+            return reallocate_emplace_slow(new_capacity, index, std::forward<Args>(args)...);
+        }
+    }
+    template<typename... Args>
+    T* reallocate_emplace_slow (const size_t new_capacity, const size_t index, Args&&... args) {
+        T* new_data_m = allocate(new_capacity);
+        try {
+            construct(new_data_m + index, std::forward<Args>(args)...);
+        } catch (...) {
+            deallocate(new_data_m, new_capacity);
+            throw;
+        }
+        try {
+            relocate(new_data_m, index);
+        } catch (...) {
+            destroy(new_data_m + index, new_data_m + index + 1);
+            deallocate(new_data_m, new_capacity);
+            throw;
+        }
+        deallocate(data_m, capacity_m);
+        data_m = new_data_m;
+        capacity_m = new_capacity;
+        ++size_m;
+        return data_m + index;
+    }
+
+    void steal (my_vector& other) noexcept {
+        data_m = other.data_m;
+        size_m = other.size_m;
+        capacity_m = other.capacity_m;
+        other.data_m = nullptr;
+        other.size_m = 0;
+        other.capacity_m = 0;
+    }
+    void swap_storage (my_vector& other) noexcept {
+        std::swap (data_m, other.data_m);
+        std::swap (size_m, other.size_m);
+        std::swap (capacity_m, other.capacity_m);
     }
 
 public:
+    // guaranteed alignment of data(): the allocator's alignment member when
+    // it has one (aligned_allocator), otherwise the element's own
+    static constexpr size_t alignment = [] {
+        if constexpr (requires { Alloc::alignment; }) {
+            return static_cast<size_t>(Alloc::alignment);
+        } else {
+            return alignof(T);
+        }
+    }();
+    // capacity() is always a multiple of this many elements, so the buffer
+    // ends on a whole SIMD vector of the allocator's alignment
+    static constexpr size_t lane_elements =
+            alignment > sizeof(T) && alignment % sizeof(T) == 0 ? alignment / sizeof(T) : 1;
+
+    using value_type = T;
+    using allocator_type = Alloc;
+
     // constructors
-    my_vector () : data_m(nullptr), size_m (0), capacity_m (0) {}
-    my_vector (const size_t n, const T& value) {
-        capacity_m = align_to_16 (n);
-        size_m = n;
-        data_m = new T[capacity_m];
-        for (size_t i = 0; i < size_m; i++) {
-            data_m[i] = value;
+    my_vector () noexcept(noexcept(Alloc())) : data_m(nullptr), size_m (0), capacity_m (0), alloc_m () {}
+    explicit my_vector (const Alloc& alloc) noexcept : data_m(nullptr), size_m (0), capacity_m (0), alloc_m (alloc) {}
+    my_vector (const size_t n, const T& value, const Alloc& alloc = Alloc()) : data_m(nullptr), size_m (0), capacity_m (0), alloc_m (alloc) {
+        capacity_m = grown_capacity (n);
+        data_m = allocate(capacity_m);
+        try {
+            construct_fill(data_m, n, value);
+        } catch (...) {
+            deallocate(data_m, capacity_m);
+            throw;
         }
+        size_m = n;
     }
-    my_vector (std::initializer_list<T> init) {
+    my_vector (std::initializer_list<T> init, const Alloc& alloc = Alloc()) : data_m(nullptr), size_m (0), capacity_m (0), alloc_m (alloc) {
         allocate_and_copy(init.begin(), init.size());
     }
     template<typename InputIt, typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
-    my_vector (InputIt first, InputIt last) {
-        allocate_and_copy(first, last - first);
+    my_vector (InputIt first, InputIt last, const Alloc& alloc = Alloc()) : data_m(nullptr), size_m (0), capacity_m (0), alloc_m (alloc) {
+        using category = typename std::iterator_traits<InputIt>::iterator_category;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+            allocate_and_copy(first, static_cast<size_t>(std::distance(first, last)));
+        } else {
+            try {
+                for (; first != last; ++first) {
+                    emplace_back(*first);
+                }
+            } catch (...) {
+                destroy_all();
+                throw;
+            }
+        }
     }
 
     // copy
-    my_vector (const my_vector& other) {
+    my_vector (const my_vector& other) : data_m(nullptr), size_m (0), capacity_m (0),
+            alloc_m (alloc_traits::select_on_container_copy_construction(other.alloc_m)) {
+        if constexpr (vector_stats_enabled) {
+            stats::on_copy(other.size_m * sizeof(T));
+        }
+        allocate_and_copy(other.data_m, other.size_m);
+    }
+    my_vector (const my_vector& other, const Alloc& alloc) : data_m(nullptr), size_m (0), capacity_m (0), alloc_m (alloc) {
+        if constexpr (vector_stats_enabled) {
+            stats::on_copy(other.size_m * sizeof(T));
+        }
         allocate_and_copy(other.data_m, other.size_m);
     }
     my_vector& operator=(const my_vector& other) {
         if (this != &other) {
-            delete [] data_m;
-            allocate_and_copy(other.data_m, other.size_m);
+            if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+                if (alloc_m != other.alloc_m) {
+                    // memory owned by the old allocator must go back to it
+                    destroy_all();
+                    data_m = nullptr;
+                    size_m = 0;
+                    capacity_m = 0;
+                }
+                alloc_m = other.alloc_m;
+            }
+            my_vector tmp(other, alloc_m);
+            swap_storage(tmp);
         }
         return *this;
     }
 
     // move
-    my_vector (my_vector&& other)  noexcept : data_m (other.data_m), size_m (other.size_m), capacity_m (other.capacity_m) {
-        other.data_m = nullptr;
-        other.size_m = 0;
-        other.capacity_m = 0;
+    my_vector (my_vector&& other) noexcept : data_m (nullptr), size_m (0), capacity_m (0), alloc_m (std::move(other.alloc_m)) {
+        steal(other);
+    }
+    my_vector (my_vector&& other, const Alloc& alloc) : data_m (nullptr), size_m (0), capacity_m (0), alloc_m (alloc) {
+        if (alloc_m == other.alloc_m) {
+            steal(other);
+        } else {
+            if constexpr (vector_stats_enabled) {
+                stats::on_move(other.size_m * sizeof(T));
+            }
+            allocate_and_copy(std::make_move_iterator(other.data_m), other.size_m);
+        }
     }
-    my_vector& operator=(my_vector&& other) noexcept {
+    my_vector& operator=(my_vector&& other) noexcept(alloc_traits::propagate_on_container_move_assignment::value
+                                                     || alloc_traits::is_always_equal::value) {
         if (this != &other) {
-            delete [] data_m;
-            data_m = other.data_m;
-            size_m = other.size_m;
-            capacity_m = other.capacity_m;
-            other.data_m = nullptr;
-            other.capacity_m = 0;
+            if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+                destroy_all();
+                alloc_m = std::move(other.alloc_m);
+                steal(other);
+            } else {
+                if (alloc_m == other.alloc_m) {
+                    destroy_all();
+                    steal(other);
+                } else {
+                    // storage cannot change hands, move element by element
+                    my_vector tmp(std::move(other), alloc_m);
+                    swap_storage(tmp);
+                }
+            }
         }
         return *this;
     }
 
+    [[nodiscard]] Alloc get_allocator() const {
+        return alloc_m;
+    }
+
     // destructor
     ~my_vector() {
-        delete [] data_m;
+        if constexpr (vector_stats_enabled) {
+            stats::sample(capacity_m, size_m);
+        }
+        destroy_all();
     }
 
     // access operators
@@ -171,175 +549,173 @@ public:
     [[nodiscard]] size_t size() const {
         return size_m;
     }
+    T* data() {
+        return data_m;
+    }
+    const T* data() const {
+        return data_m;
+    }
+    // data() with its alignment known to the compiler, so loops over it
+    // vectorize without a peel loop for the unaligned head
+    T* aligned_data() {
+        return std::assume_aligned<alignment>(data_m);
+    }
+    const T* aligned_data() const {
+        return std::assume_aligned<alignment>(data_m);
+    }
     void reserve (size_t new_capacity) {
         if (new_capacity == 0) {
             new_capacity = 2;
         }
         if (new_capacity > capacity_m) {
-            new_capacity = align_to_16 (new_capacity);
-            T* new_data_m = new T[new_capacity];
-            for (size_t i = 0; i < size_m; i++) {
-                new_data_m[i] = data_m[i];
-            }
-            delete [] data_m;
-            data_m = new_data_m;
-            capacity_m = new_capacity;
+            reallocate(pad_to_lanes(align_to_16 (new_capacity)));
         }
     }
     [[nodiscard]] size_t capacity() const {
         return capacity_m;
     }
     void shrink_to_fit () {
-        capacity_m = size_m;
-        T* new_data_m = new T[capacity_m];
-        for (size_t i = 0; i < size_m; i++) {
-            new_data_m[i] = data_m[i];
+        if (capacity_m != pad_to_lanes(size_m)) {
+            reallocate(pad_to_lanes(size_m));
         }
-        delete [] data_m;
-        data_m = new_data_m;
     }
 
     // swap
     void swap (my_vector& other) noexcept {
-        std::swap (data_m, other.data_m);
-        std::swap (size_m, other.size_m);
-        std::swap (capacity_m, other.capacity_m);
+        if constexpr (alloc_traits::propagate_on_container_swap::value) {
+            std::swap (alloc_m, other.alloc_m);
+        }
+        swap_storage(other);
     }
 
     // clear, resize
     void clear () {
+        destroy(data_m, data_m + size_m);
         size_m = 0;
     }
     void resize(const size_t new_size) {
-        resize(new_size, T());
-    }
-    void resize(size_t new_size, const T& value) {
-        if (new_size < size_m) {
-            size_m = new_size;
-        } else if (new_size > size_m && new_size < capacity_m) {
-            for (size_t i = size_m; i < new_size; ++i) {
-                data_m[i] = value;
-            }
-            size_m = new_size;
+        if (new_size <= size_m) {
+            destroy(data_m + new_size, data_m + size_m);
+        } else {
+            grow_to_fit (new_size);
+            construct_default(data_m + size_m, new_size - size_m);
         }
-        else {
-            reserve (new_size);
-            for (size_t i = size_m; i < new_size; ++i) {
-                data_m[i] = value;
-            }
+        size_m = new_size;
+    }
+    // resize() that leaves new elements uninitialized when T allows it
+    // (trivially default constructible, no allocator construct()), for
+    // callers about to overwrite them, e.g. by reading from a file
+    void resize_for_overwrite(const size_t new_size) {
+        if constexpr (bytewise_construct && std::is_trivially_default_constructible_v<T>) {
+            grow_to_fit(new_size);
             size_m = new_size;
+        } else {
+            resize(new_size);
         }
     }
+    void resize(size_t new_size, const T& value) {
+        if (new_size <= size_m) {
+            destroy(data_m + new_size, data_m + size_m);
+        } else if (new_size <= capacity_m) {
+            construct_fill(data_m + size_m, new_size - size_m, value);
+        } else {
+            // value may alias an element that is about to be relocated
+            T copy = value;
+            grow_to_fit (new_size);
+            construct_fill(data_m + size_m, new_size - size_m, copy);
+        }
+        size_m = new_size;
+    }
 
     // inserts
     T* insert(T* it, const T& value) {
-        size_t index = it - data_m;
-        if (size_m == capacity_m) {
-            reserve(align_to_16(size_m * 2));
-            it = data_m + index;
-        }
-
-        for (size_t i = size_m; i > index; i--) {
-            data_m[i] = std::move(data_m[i - 1]);
-        }
-
-        data_m[index] = value;
-        ++size_m;
-        return data_m + index;
+        return emplace(it, value);
+    }
+    T* insert(T* it, T&& value) {
+        return emplace(it, std::move(value));
     }
 
     template<typename InputIt>
     T* insert(T* it, InputIt first, InputIt last) {
         size_t index = it - data_m;
         const size_t count = std::distance(first, last);
-        if (size_m + count > capacity_m) {
-            reserve(align_to_16(size_m * 2 + count));
-            it = data_m + index;
-        }
-
-        for (size_t i = size_m + count; i-- > index + count; ) {
-            data_m[i] = std::move(data_m[i - count]);
+        if (count == 0) {
+            return data_m + index;
         }
-
-        std::copy(first, last, data_m + index);
-        size_m += count;
+        grow_to_fit(size_m + count);
+        range_insert(allocator_storage {*this}, data_m, size_m, index, first, count);
         return data_m + index;
     }
 
     // erase
     T* erase(T* pos) {
-        size_t index = pos - data_m;
-
-        for (size_t i = index; i + 1 < size_m; ++i) {
-            data_m[i] = std::move(data_m[i + 1]);
-        }
-
-        size_m--;
-        return data_m + index;
+        return erase(pos, pos + 1);
     }
     T* erase(T* first, T* last) {
-        size_t start = first - data_m;
-        const size_t count = last - first;
-        for (size_t i = start; i < last; ++i)
-            data_m[i] = std::move(data_m[i + count]);
-        size_m -= count;
+        const size_t start = first - data_m;
+        range_erase(allocator_storage {*this}, data_m, size_m, start, static_cast<size_t>(last - first));
         return data_m + start;
     }
 
     // pop, push, emplace
     void pop_back() {
         if (size_m > 0) {
-            size_m--;
+            --size_m;
+            destroy(data_m + size_m, data_m + size_m + 1);
         }
     }
 
     void push_back(const T& value) {
-        if (size_m == capacity_m) {
-            reserve((size_m) * 2);
-        }
-        data_m[size_m++] = value;
+        emplace_back(value);
     }
     void push_back(T&& value) {
-        if (size_m == capacity_m) {
-            reserve(size_m * 2);
+        emplace_back(std::move(value));
+    }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (size_m == capacity_m && !try_expand(grown_capacity(size_m + 1))) {
+            return *reallocate_emplace(size_m, std::forward<Args>(args)...);
         }
-        data_m[size_m++] = std::move(value);
+        construct(data_m + size_m, std::forward<Args>(args)...);
+        return data_m[size_m++];
     }
 
     template<typename... Args>
-    void emplace_back(Args&&... args) {
-        if (size_m == capacity_m) {
-            reserve((size_m == 0 ? 1 : size_m) * 2);
+    T* emplace(T* pos, Args&&... args) {
+        const size_t index = pos - data_m;
+        if (size_m == capacity_m && !try_expand(grown_capacity(size_m + 1))) {
+            return reallocate_emplace(index, std::forward<Args>(args)...);
         }
-        data_m[size_m++] = T(std::forward<Args>(args)...);
+        range_emplace(allocator_storage {*this}, data_m, size_m, index, std::forward<Args>(args)...);
+        return data_m + index;
     }
 
     friend bool operator==(const my_vector& a, const my_vector& b) {
-        return a.size_m == b.size_m && std::equal(a.begin(), a.end(), b.begin());
+        return a.size_m == b.size_m && elements_equal(a.data_m, b.data_m, a.size_m);
     }
 
     friend bool operator!=(const my_vector& a, const my_vector& b) {
         return !(a == b);
     }
 
-    friend bool operator<(const my_vector& a, const my_vector& b) {
-        return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
-    }
-
-    friend bool operator>(const my_vector& a, const my_vector& b) {
-        return b < a;
+    // <, >, <= and >= are rewritten in terms of <=>, one pass per comparison
+    friend auto operator<=>(const my_vector& a, const my_vector& b) {
+        return elements_compare(a.data_m, a.size_m, b.data_m, b.size_m);
     }
 
-    friend bool operator<=(const my_vector& a, const my_vector& b) {
-        return !(b < a);
-    }
+};
 
-    friend bool operator>=(const my_vector& a, const my_vector& b) {
-        return !(a < b);
-    }
 
-};
 
+namespace pmr {
+    template <typename T, typename Growth = growth_factor_2>
+    using my_vector = ::my_vector<T, Growth, std::pmr::polymorphic_allocator<T>>;
+}
 
+// my_vector for SIMD kernels: 64-byte (cache line, AVX-512) aligned storage
+// by default, 32 is enough for AVX2
+template <typename T, size_t Alignment = 64, typename Growth = growth_factor_2>
+using aligned_vector = my_vector<T, Growth, aligned_allocator<T, Alignment>>;
 
 #endif //MY_VECTOR_H
@@ -0,0 +1,118 @@
+#ifndef RANGE_EDIT_H
+#define RANGE_EDIT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "relocation.h"
+
+// insert, emplace and erase on a buffer whose first size elements are
+// constructed, shared by my_vector, my_small_vector and my_static_vector.
+// The caller has already made room for the new elements. Elements are
+// created and destroyed through a Storage with construct(p, args...) and
+// destroy(first, last), passed by value, so my_vector can route them
+// through its allocator.
+//
+// size is raised as soon as the elements past the old end exist, so when
+// a copy or move assignment throws halfway, every constructed element is
+// still counted and the container's destructor releases it.
+
+// constructs and destroys with std::construct_at / std::destroy
+struct default_range_storage {
+    template <typename T, typename... Args>
+    static void construct (T* p, Args&&... args) {
+        std::construct_at(p, std::forward<Args>(args)...);
+    }
+    template <typename T>
+    static void destroy (T* first, T* last) noexcept {
+        std::destroy(first, last);
+    }
+};
+
+namespace range_edit_detail {
+    // constructs n elements at dst from src, undoing the partial work on throw
+    template <typename Storage, typename InputIt, typename T>
+    void construct_n (Storage& storage, InputIt src, const size_t n, T* dst) {
+        size_t i = 0;
+        try {
+            for (; i < n; ++i, ++src) {
+                storage.construct(dst + i, *src);
+            }
+        } catch (...) {
+            storage.destroy(dst, dst + i);
+            throw;
+        }
+    }
+}
+
+// inserts the count elements of [first, ...) before index
+template <typename Storage, typename T, typename InputIt>
+void range_insert (Storage storage, T* const data, size_t& size, const size_t index, InputIt first,
+                   const size_t count) {
+    T* pos = data + index;
+    T* old_end = data + size;
+    const size_t after = size - index;
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        move_elements(pos, old_end, pos + count);
+        std::copy_n(first, count, pos);
+        size += count;
+    } else if (count <= after) {
+        // the last count elements move up into raw storage, the rest shift
+        range_edit_detail::construct_n(storage, std::make_move_iterator(old_end - count), count, old_end);
+        size += count;
+        move_elements(pos, old_end - count, pos + count);
+        std::copy_n(first, count, pos);
+    } else {
+        // the new elements past the old end are constructed in place, the
+        // whole tail moves up behind them
+        InputIt mid = std::next(first, after);
+        range_edit_detail::construct_n(storage, mid, count - after, old_end);
+        try {
+            range_edit_detail::construct_n(storage, std::make_move_iterator(pos), after, pos + count);
+        } catch (...) {
+            storage.destroy(old_end, old_end + (count - after));
+            throw;
+        }
+        size += count;
+        std::copy_n(first, after, pos);
+    }
+}
+
+// constructs an element from args before index; data[size] must be raw
+template <typename Storage, typename T, typename... Args>
+void range_emplace (Storage storage, T* const data, size_t& size, const size_t index, Args&&... args) {
+    if (index == size) {
+        storage.construct(data + size, std::forward<Args>(args)...);
+        ++size;
+        return;
+    }
+    // the slot is occupied until the tail shifts, and args may refer to an
+    // element that is about to move
+    T tmp(std::forward<Args>(args)...);
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        move_elements(data + index, data + size, data + index + 1);
+        storage.construct(data + index, std::move(tmp));
+        ++size;
+    } else {
+        storage.construct(data + size, std::move(data[size - 1]));
+        ++size;
+        move_elements(data + index, data + size - 2, data + index + 1);
+        data[index] = std::move(tmp);
+    }
+}
+
+// removes the count elements starting at index
+template <typename Storage, typename T>
+void range_erase (Storage storage, T* const data, size_t& size, const size_t index, const size_t count) {
+    if (count == 0) {
+        return;
+    }
+    move_elements(data + index + count, data + size, data + index);
+    storage.destroy(data + size - count, data + size);
+    size -= count;
+}
+
+#endif //RANGE_EDIT_H
@@ -0,0 +1,36 @@
+#ifndef RELOCATION_H
+#define RELOCATION_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+// Types for which moving the bytes to a new address and forgetting the
+// old copy is equivalent to move-construct + destroy. Specialize it to
+// opt in types that are not trivially copyable but own no self-pointers.
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+// Move-assigns [first, last) onto the constructed range starting at dest,
+// which may overlap it in either direction. Trivially copyable types go
+// through a single memmove instead of an element loop.
+template <typename T>
+T* move_elements (T* first, T* last, T* dest) {
+    const size_t n = last - first;
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        if (n != 0) {
+            std::memmove(static_cast<void*>(dest), static_cast<const void*>(first), n * sizeof(T));
+        }
+    } else if (dest < first) {
+        std::move(first, last, dest);
+    } else {
+        std::move_backward(first, last, dest + n);
+    }
+    return dest + n;
+}
+
+#endif //RELOCATION_H
@@ -0,0 +1,529 @@
+#ifndef SERIALIZATION_H
+#define SERIALIZATION_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "my_array.h"
+#include "my_vector.h"
+
+// Versioned binary format for my_vector, my_array and other contiguous
+// containers: a 64-byte serial_header followed by the payload.
+//
+// Trivially copyable elements are stored as their raw bytes, so a whole
+// container is written with one write()/writev() and a loaded or mmapped
+// buffer can be read in place through serial_view. Other element types
+// need a serial_codec specialization (one is provided for std::string);
+// they are written through a fixed-size chunk, so no encoded copy of the
+// whole container is built. Byte order is the host's, the format is meant for
+// persisting and shipping data between like machines.
+
+inline constexpr char serial_magic[4] = {'M', 'Y', 'S', 'R'};
+inline constexpr uint16_t serial_version = 1;
+
+// payload kinds
+inline constexpr uint16_t serial_raw = 0;     // count * element_size bytes
+inline constexpr uint16_t serial_encoded = 1; // serial_codec records
+
+struct serial_header {
+    char magic[4];
+    uint16_t version;
+    uint16_t kind;
+    uint32_t alignment;
+    uint32_t reserved0;
+    uint64_t type_tag;
+    uint64_t element_size;
+    uint64_t count;
+    uint64_t payload_bytes;
+    uint64_t checksum;
+    uint64_t reserved1;
+};
+static_assert(sizeof(serial_header) == 64);
+
+// the payload starts right after the header, so this is the largest
+// element alignment a view over a 64-byte aligned buffer can honour
+inline constexpr size_t serial_payload_alignment = sizeof(serial_header);
+
+// type tag
+
+namespace serial_detail {
+    constexpr uint64_t fnv1a (const std::string_view s) {
+        uint64_t h = 14695981039346656037ull;
+        for (const char c : s) {
+            h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+        }
+        return h;
+    }
+
+    template <typename T>
+    constexpr std::string_view type_signature () {
+#if defined(__GNUC__) || defined(__clang__)
+        return __PRETTY_FUNCTION__;
+#else
+        return __FUNCSIG__;
+#endif
+    }
+}
+
+// identifies the element type in the header. The default hashes the
+// compiler's spelling of the type; specialize it for types whose files
+// have to be read by binaries from another compiler.
+template <typename T>
+struct serial_type_tag {
+    static constexpr uint64_t value = serial_detail::fnv1a(serial_detail::type_signature<T>());
+};
+
+// checksum
+
+// four independent multiply-xor lanes over 8-byte words, so it runs at
+// memory speed; the result does not depend on how the input is split
+// across update() calls
+class serial_checksum {
+    static constexpr uint64_t prime = 0x9E3779B97F4A7C15ull;
+
+    uint64_t lanes_m[4] = {1, 2, 3, 4};
+    unsigned char pending_m[32] {};
+    size_t pending_size_m = 0;
+    uint64_t total_m = 0;
+
+    static uint64_t mix (uint64_t h, const uint64_t word) {
+        h ^= word * prime;
+        h = (h << 31) | (h >> 33);
+        return h * 0xC2B2AE3D27D4EB4Full;
+    }
+
+    void block (const unsigned char* p) {
+        for (size_t lane = 0; lane < 4; ++lane) {
+            uint64_t word;
+            std::memcpy(&word, p + lane * 8, 8);
+            lanes_m[lane] = mix(lanes_m[lane], word);
+        }
+    }
+
+public:
+    void update (const void* data, size_t n) {
+        const auto* p = static_cast<const unsigned char*>(data);
+        total_m += n;
+        if (pending_size_m != 0) {
+            const size_t take = std::min(n, 32 - pending_size_m);
+            std::memcpy(pending_m + pending_size_m, p, take);
+            pending_size_m += take;
+            p += take;
+            n -= take;
+            if (pending_size_m < 32) {
+                return;
+            }
+            block(pending_m);
+            pending_size_m = 0;
+        }
+        for (; n >= 32; p += 32, n -= 32) {
+            block(p);
+        }
+        std::memcpy(pending_m, p, n);
+        pending_size_m = n;
+    }
+
+    [[nodiscard]] uint64_t finish () const {
+        uint64_t h = total_m;
+        for (const uint64_t lane : lanes_m) {
+            h = mix(h, lane);
+        }
+        for (size_t i = 0; i < pending_size_m; ++i) {
+            h = mix(h, pending_m[i]);
+        }
+        return h ^ (h >> 29);
+    }
+
+    static uint64_t of (const void* data, const size_t n) {
+        serial_checksum sum;
+        sum.update(data, n);
+        return sum.finish();
+    }
+};
+
+// codecs for element types that are not trivially copyable
+
+// encode() appends the bytes of one element to out; decode() reads one
+// element from [p, end) into value and returns the position after it
+template <typename T>
+struct serial_codec;
+
+template <>
+struct serial_codec<std::string> {
+    static void encode (const std::string& value, std::string& out) {
+        uint64_t n = value.size();
+        // LEB128 length prefix
+        do {
+            const auto byte = static_cast<unsigned char>(n & 0x7F);
+            n >>= 7;
+            out.push_back(static_cast<char>(n != 0 ? byte | 0x80 : byte));
+        } while (n != 0);
+        out.append(value);
+    }
+    static const char* decode (const char* p, const char* end, std::string& value) {
+        uint64_t n = 0;
+        for (unsigned shift = 0;; shift += 7) {
+            if (p == end || shift > 63) {
+                throw std::runtime_error("Truncated string length in serialized payload");
+            }
+            const auto byte = static_cast<unsigned char>(*p++);
+            n |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                break;
+            }
+        }
+        if (n > static_cast<uint64_t>(end - p)) {
+            throw std::runtime_error("Truncated string in serialized payload");
+        }
+        value.assign(p, static_cast<size_t>(n));
+        return p + n;
+    }
+};
+
+namespace serial_detail {
+    template <typename Container>
+    using element_t = std::remove_cv_t<std::remove_pointer_t<decltype(std::declval<const Container&>().data())>>;
+
+    template <typename T>
+    inline constexpr bool is_raw_v = std::is_trivially_copyable_v<T>;
+
+    // encoded payloads are produced in chunks of about this size
+    inline constexpr size_t encode_chunk = size_t(64) << 10;
+
+    template <typename T>
+    serial_header make_header (const size_t count) {
+        serial_header h {};
+        std::memcpy(h.magic, serial_magic, sizeof(serial_magic));
+        h.version = serial_version;
+        h.type_tag = serial_type_tag<T>::value;
+        h.element_size = sizeof(T);
+        h.count = count;
+        if constexpr (is_raw_v<T>) {
+            h.kind = serial_raw;
+            h.alignment = alignof(T);
+            h.payload_bytes = count * sizeof(T);
+        } else {
+            h.kind = serial_encoded;
+            h.alignment = 1;
+        }
+        return h;
+    }
+
+    // encodes [first, first + n) chunk by chunk, handing every chunk to sink
+    template <typename T, typename Sink>
+    void encode_chunks (const T* first, const size_t n, Sink&& sink) {
+        std::string chunk;
+        chunk.reserve(encode_chunk);
+        for (size_t i = 0; i < n; ++i) {
+            serial_codec<T>::encode(first[i], chunk);
+            if (chunk.size() >= encode_chunk) {
+                sink(chunk.data(), chunk.size());
+                chunk.clear();
+            }
+        }
+        if (!chunk.empty()) {
+            sink(chunk.data(), chunk.size());
+        }
+    }
+
+    // the header of an encoded payload needs its size and checksum, so the
+    // elements are encoded twice rather than buffered
+    template <typename T>
+    void measure_encoded (const T* first, const size_t n, serial_header& h) {
+        serial_checksum sum;
+        uint64_t total = 0;
+        encode_chunks(first, n, [&](const char* p, const size_t bytes) {
+            sum.update(p, bytes);
+            total += bytes;
+        });
+        h.payload_bytes = total;
+        h.checksum = sum.finish();
+    }
+
+    inline void write_all (const int fd, const void* data, size_t bytes) {
+        const auto* p = static_cast<const char*>(data);
+        while (bytes != 0) {
+            const ssize_t written = ::write(fd, p, bytes);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "write");
+            }
+            p += written;
+            bytes -= static_cast<size_t>(written);
+        }
+    }
+
+    // header and payload in one writev; a short write (large payloads, pipes)
+    // is finished with plain writes
+    inline void writev_all (const int fd, const serial_header& h, const void* payload, const size_t bytes) {
+        iovec iov[2] = {
+            {const_cast<serial_header*>(&h), sizeof(h)},
+            {const_cast<void*>(payload), bytes},
+        };
+        ssize_t written;
+        do {
+            written = ::writev(fd, iov, 2);
+        } while (written < 0 && errno == EINTR);
+        if (written < 0) {
+            throw std::system_error(errno, std::generic_category(), "writev");
+        }
+        const auto done = static_cast<size_t>(written);
+        if (done < sizeof(h)) {
+            write_all(fd, reinterpret_cast<const char*>(&h) + done, sizeof(h) - done);
+            write_all(fd, payload, bytes);
+        } else {
+            write_all(fd, static_cast<const char*>(payload) + (done - sizeof(h)), bytes - (done - sizeof(h)));
+        }
+    }
+
+    inline void check_header (const serial_header& h, const uint64_t type_tag, const size_t element_size,
+                              const uint16_t kind) {
+        if (std::memcmp(h.magic, serial_magic, sizeof(serial_magic)) != 0) {
+            throw std::runtime_error("Not a serialized container");
+        }
+        if (h.version != serial_version) {
+            throw std::runtime_error("Unsupported serialization version " + std::to_string(h.version));
+        }
+        if (h.type_tag != type_tag || h.element_size != element_size) {
+            throw std::runtime_error("Serialized container holds a different element type");
+        }
+        // every reader sizes its buffers by the kind it expects, so a raw
+        // type must never be handed an encoded payload or the reverse
+        if (h.kind != kind) {
+            throw std::runtime_error("Serialized payload kind does not match the element type");
+        }
+        // element_size is sizeof(T) here, so never 0; the division keeps a
+        // crafted count from wrapping count * element_size around
+        if (kind == serial_raw
+            && (h.count > UINT64_MAX / h.element_size || h.payload_bytes != h.count * h.element_size)) {
+            throw std::runtime_error("Serialized payload size does not match the element count");
+        }
+    }
+
+    inline void read_exact (std::istream& in, void* dst, const size_t bytes) {
+        in.read(static_cast<char*>(dst), static_cast<std::streamsize>(bytes));
+        if (static_cast<size_t>(in.gcount()) != bytes) {
+            throw std::runtime_error("Serialized container is truncated");
+        }
+    }
+
+    template <typename T>
+    serial_header read_header (std::istream& in) {
+        serial_header h {};
+        read_exact(in, &h, sizeof(h));
+        check_header(h, serial_type_tag<T>::value, sizeof(T), is_raw_v<T> ? serial_raw : serial_encoded);
+        return h;
+    }
+
+    // payloads are read in pieces of about this size
+    inline constexpr size_t read_chunk = size_t(1) << 20;
+
+    // reads count elements into out, growing it through resize(n) a chunk
+    // at a time: a header that claims more than the stream holds fails at
+    // the first short read instead of allocating all of it up front
+    template <typename Container, typename Resize>
+    void read_chunked (std::istream& in, Container& out, const uint64_t count, Resize&& resize) {
+        constexpr size_t element_size = sizeof(*out.data());
+        constexpr size_t chunk = std::max<size_t>(1, read_chunk / element_size);
+        for (uint64_t done = 0; done < count;) {
+            const auto n = static_cast<size_t>(std::min<uint64_t>(count - done, chunk));
+            resize(done + n);
+            read_exact(in, out.data() + done, n * element_size);
+            done += n;
+        }
+    }
+
+    inline std::string read_encoded_payload (std::istream& in, const serial_header& h) {
+        std::string payload;
+        read_chunked(in, payload, h.payload_bytes, [&](const size_t n) {
+            payload.resize(n);
+        });
+        return payload;
+    }
+
+    inline void verify (const serial_header& h, const void* payload) {
+        if (serial_checksum::of(payload, h.payload_bytes) != h.checksum) {
+            throw std::runtime_error("Checksum mismatch in serialized container");
+        }
+    }
+
+    // decodes h.count elements from the payload, calling put(value) for each
+    template <typename T, typename Put>
+    void decode_all (const serial_header& h, const char* p, Put&& put) {
+        const char* end = p + h.payload_bytes;
+        T value;
+        for (uint64_t i = 0; i < h.count; ++i) {
+            p = serial_codec<T>::decode(p, end, value);
+            put(std::move(value));
+        }
+        if (p != end) {
+            throw std::runtime_error("Trailing bytes in serialized payload");
+        }
+    }
+}
+
+// write
+
+template <typename Container>
+void serialize (std::ostream& out, const Container& c) {
+    using T = serial_detail::element_t<Container>;
+    serial_header h = serial_detail::make_header<T>(c.size());
+    if constexpr (serial_detail::is_raw_v<T>) {
+        h.checksum = serial_checksum::of(c.data(), h.payload_bytes);
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        out.write(reinterpret_cast<const char*>(c.data()), static_cast<std::streamsize>(h.payload_bytes));
+    } else {
+        serial_detail::measure_encoded(c.data(), c.size(), h);
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        serial_detail::encode_chunks(c.data(), c.size(), [&](const char* p, const size_t bytes) {
+            out.write(p, static_cast<std::streamsize>(bytes));
+        });
+    }
+    if (!out) {
+        throw std::runtime_error("Failed to write serialized container");
+    }
+}
+
+template <typename Container>
+void serialize (const int fd, const Container& c) {
+    using T = serial_detail::element_t<Container>;
+    serial_header h = serial_detail::make_header<T>(c.size());
+    if constexpr (serial_detail::is_raw_v<T>) {
+        h.checksum = serial_checksum::of(c.data(), h.payload_bytes);
+        serial_detail::writev_all(fd, h, c.data(), h.payload_bytes);
+    } else {
+        serial_detail::measure_encoded(c.data(), c.size(), h);
+        serial_detail::write_all(fd, &h, sizeof(h));
+        serial_detail::encode_chunks(c.data(), c.size(), [&](const char* p, const size_t bytes) {
+            serial_detail::write_all(fd, p, bytes);
+        });
+    }
+}
+
+// read
+
+template <typename T>
+my_vector<T> deserialize (std::istream& in) {
+    const serial_header h = serial_detail::read_header<T>(in);
+    my_vector<T> result;
+    if constexpr (serial_detail::is_raw_v<T>) {
+        serial_detail::read_chunked(in, result, h.count, [&](const size_t n) {
+            result.resize_for_overwrite(n);
+        });
+        serial_detail::verify(h, result.data());
+    } else {
+        const std::string payload = serial_detail::read_encoded_payload(in, h);
+        serial_detail::verify(h, payload.data());
+        // only a hint: a hostile count must not reserve more records than
+        // the payload has bytes
+        result.reserve(std::min(h.count, h.payload_bytes));
+        serial_detail::decode_all<T>(h, payload.data(), [&](T&& value) {
+            result.push_back(std::move(value));
+        });
+    }
+    return result;
+}
+
+template <typename T, size_t N>
+void deserialize (std::istream& in, my_array<T, N>& out) {
+    const serial_header h = serial_detail::read_header<T>(in);
+    if (h.count != N) {
+        throw std::runtime_error("Serialized container has " + std::to_string(h.count) + " elements, expected "
+                                 + std::to_string(N));
+    }
+    if constexpr (serial_detail::is_raw_v<T>) {
+        // read in place; out holds garbage if the checksum then fails
+        serial_detail::read_exact(in, out.data(), h.payload_bytes);
+        serial_detail::verify(h, out.data());
+    } else {
+        const std::string payload = serial_detail::read_encoded_payload(in, h);
+        serial_detail::verify(h, payload.data());
+        size_t i = 0;
+        serial_detail::decode_all<T>(h, payload.data(), [&](T&& value) {
+            out[i++] = std::move(value);
+        });
+    }
+}
+
+// zero-copy view
+
+// read-only elements of a serialized container, pointing into the buffer
+// it was created from; the buffer must outlive the view
+template <typename T>
+class serial_view {
+    const T* data_m = nullptr;
+    size_t size_m = 0;
+
+public:
+    serial_view () = default;
+    serial_view (const T* data, const size_t size) : data_m(data), size_m(size) {}
+
+    const T& operator[](const size_t index) const {
+        return data_m[index];
+    }
+    const T& at(const size_t index) const {
+        if (index >= size_m) {
+            throw std::out_of_range("Index out of range in at()");
+        }
+        return data_m[index];
+    }
+
+    const T* begin() const {
+        return data_m;
+    }
+    const T* end() const {
+        return data_m + size_m;
+    }
+    [[nodiscard]] bool is_empty() const {
+        return size_m == 0;
+    }
+    [[nodiscard]] size_t size() const {
+        return size_m;
+    }
+    const T* data() const {
+        return data_m;
+    }
+};
+
+// validates the header in [buffer, buffer + bytes) and returns a view of
+// its payload without copying. The checksum pass reads every byte; skip it
+// with verify = false when the buffer is mmapped and only a part of it
+// will be touched.
+template <typename T>
+serial_view<T> view_serialized (const void* buffer, const size_t bytes, const bool verify = true) {
+    static_assert(serial_detail::is_raw_v<T>, "only trivially copyable elements can be viewed in place");
+    static_assert(alignof(T) <= serial_payload_alignment, "element alignment exceeds the payload alignment");
+    if (bytes < sizeof(serial_header)) {
+        throw std::runtime_error("Serialized container is truncated");
+    }
+    serial_header h {};
+    std::memcpy(&h, buffer, sizeof(h));
+    serial_detail::check_header(h, serial_type_tag<T>::value, sizeof(T), serial_raw);
+    if (h.payload_bytes > bytes - sizeof(serial_header)
+        || h.count > (bytes - sizeof(serial_header)) / sizeof(T)) {
+        throw std::runtime_error("Serialized container is truncated");
+    }
+    const auto* payload = static_cast<const unsigned char*>(buffer) + sizeof(serial_header);
+    if (reinterpret_cast<uintptr_t>(payload) % alignof(T) != 0) {
+        throw std::runtime_error("Buffer is not aligned for the element type");
+    }
+    if (verify) {
+        serial_detail::verify(h, payload);
+    }
+    return serial_view<T>(reinterpret_cast<const T*>(payload), h.count);
+}
+
+#endif //SERIALIZATION_H
@@ -0,0 +1,142 @@
+#ifndef SIMD_COMPARE_H
+#define SIMD_COMPARE_H
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_COMPARE_X86 1
+#include <immintrin.h>
+#endif
+
+// Element-range comparisons shared by the containers' ==, != and <=>.
+// Integral element types compare equal exactly when their bytes do, so
+// they are compared as raw memory; everything else (floating point
+// included, because of NaN and -0.0) uses the element operators.
+
+// <=> when the type has it, otherwise an ordering derived from <
+struct synth_three_way {
+    template <typename T, typename U>
+    constexpr auto operator()(const T& a, const U& b) const {
+        if constexpr (std::three_way_comparable_with<T, U>) {
+            return a <=> b;
+        } else {
+            if (a < b) {
+                return std::weak_ordering::less;
+            }
+            if (b < a) {
+                return std::weak_ordering::greater;
+            }
+            return std::weak_ordering::equivalent;
+        }
+    }
+};
+
+template <typename T>
+using synth_three_way_result = decltype(synth_three_way()(std::declval<const T&>(), std::declval<const T&>()));
+
+namespace simd {
+    // index of the first differing byte, or n when the blocks are equal
+    inline size_t mismatch_scalar (const unsigned char* a, const unsigned char* b, const size_t n) {
+        size_t i = 0;
+        while (i < n && a[i] == b[i]) {
+            ++i;
+        }
+        return i;
+    }
+
+#ifdef SIMD_COMPARE_X86
+    __attribute__((target("sse2")))
+    inline size_t mismatch_sse2 (const unsigned char* a, const unsigned char* b, const size_t n) {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            const auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)));
+            if (mask != 0xFFFFu) {
+                return i + static_cast<size_t>(__builtin_ctz(~mask));
+            }
+        }
+        return i + mismatch_scalar(a + i, b + i, n - i);
+    }
+
+    __attribute__((target("avx2")))
+    inline size_t mismatch_avx2 (const unsigned char* a, const unsigned char* b, const size_t n) {
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            const auto mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb)));
+            if (mask != 0xFFFFFFFFu) {
+                return i + static_cast<size_t>(__builtin_ctz(~mask));
+            }
+        }
+        return i + mismatch_sse2(a + i, b + i, n - i);
+    }
+#endif
+
+    using mismatch_fn = size_t (*)(const unsigned char*, const unsigned char*, size_t);
+
+    inline mismatch_fn select_mismatch () {
+#ifdef SIMD_COMPARE_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return mismatch_avx2;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            return mismatch_sse2;
+        }
+#endif
+        return mismatch_scalar;
+    }
+
+    // picks the widest kernel the CPU supports on first use
+    inline size_t mismatch_bytes (const void* a, const void* b, const size_t n) {
+        static const mismatch_fn kernel = select_mismatch();
+        const auto* pa = static_cast<const unsigned char*>(a);
+        const auto* pb = static_cast<const unsigned char*>(b);
+        if (n < 16) {
+            return mismatch_scalar(pa, pb, n);
+        }
+        return kernel(pa, pb, n);
+    }
+}
+
+template <typename T>
+inline constexpr bool is_bytewise_comparable_v = std::is_integral_v<T>;
+
+// unsigned bytes order the same way memcmp does
+template <typename T>
+inline constexpr bool is_memcmp_orderable_v = std::is_integral_v<T> && std::is_unsigned_v<T> && sizeof(T) == 1;
+
+template <typename T>
+bool elements_equal (const T* a, const T* b, const size_t n) {
+    if constexpr (is_bytewise_comparable_v<T>) {
+        return n == 0 || std::memcmp(a, b, n * sizeof(T)) == 0;
+    } else {
+        return std::equal(a, a + n, b);
+    }
+}
+
+template <typename T>
+synth_three_way_result<T> elements_compare (const T* a, const size_t na, const T* b, const size_t nb) {
+    const size_t n = std::min(na, nb);
+    if constexpr (is_memcmp_orderable_v<T>) {
+        const int r = n == 0 ? 0 : std::memcmp(a, b, n);
+        return r != 0 ? r <=> 0 : na <=> nb;
+    } else if constexpr (is_bytewise_comparable_v<T>) {
+        const size_t byte = simd::mismatch_bytes(a, b, n * sizeof(T));
+        if (byte == n * sizeof(T)) {
+            return na <=> nb;
+        }
+        const size_t i = byte / sizeof(T);
+        return a[i] <=> b[i];
+    } else {
+        return std::lexicographical_compare_three_way(a, a + na, b, b + nb, synth_three_way());
+    }
+}
+
+#endif //SIMD_COMPARE_H
@@ -0,0 +1,125 @@
+#ifndef SIMD_FILL_H
+#define SIMD_FILL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__SSE2__)
+#define SIMD_FILL_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Bulk fill used by the containers' (n, value) constructors, resize,
+// fill and clear. For trivially copyable types the destination may be
+// raw storage: the bytes are written without running constructors.
+
+namespace simd {
+    // fills above this size would only evict the working set from the
+    // last level cache, so they bypass it with streaming stores
+    inline size_t non_temporal_threshold () {
+        static const size_t threshold = [] {
+            long llc = 0;
+#ifdef _SC_LEVEL3_CACHE_SIZE
+            llc = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+            return llc > 0 ? static_cast<size_t>(llc) : size_t(32) << 20;
+        }();
+        return threshold;
+    }
+
+    template <typename T>
+    bool is_all_zero_bytes (const T& value) {
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        return std::all_of(bytes, bytes + sizeof(T), [](const unsigned char b) { return b == 0; });
+    }
+
+    // writes the 16-byte pattern over [dst, dst + bytes) with streaming
+    // stores; dst and bytes must be multiples of the pattern period, so
+    // the pattern lines up again after the unaligned head
+    inline bool stream_pattern (unsigned char* dst, size_t bytes, const unsigned char* pattern) {
+#ifdef SIMD_FILL_SSE2
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern));
+        const size_t head = (16 - reinterpret_cast<uintptr_t>(dst) % 16) % 16;
+        std::memcpy(dst, pattern, head);
+        dst += head;
+        bytes -= head;
+        size_t i = 0;
+        for (; i + 64 <= bytes; i += 64) {
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i), v);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i + 16), v);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i + 32), v);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i + 48), v);
+        }
+        for (; i + 16 <= bytes; i += 16) {
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i), v);
+        }
+        _mm_sfence();
+        std::memcpy(dst + i, pattern, bytes - i);
+        return true;
+#else
+        (void) dst;
+        (void) bytes;
+        (void) pattern;
+        return false;
+#endif
+    }
+}
+
+template <typename T>
+inline constexpr bool is_bytewise_fillable_v = std::is_trivially_copyable_v<T>;
+
+template <typename T>
+void fill_elements (T* dst, const size_t n, const T& value) {
+    if constexpr (is_bytewise_fillable_v<T>) {
+        if (n == 0) {
+            return;
+        }
+        const size_t bytes = n * sizeof(T);
+        if (simd::is_all_zero_bytes(value)) {
+            std::memset(static_cast<void*>(dst), 0, bytes);
+            return;
+        }
+        if constexpr (sizeof(T) == 1) {
+            unsigned char byte;
+            std::memcpy(&byte, &value, 1);
+            std::memset(static_cast<void*>(dst), byte, bytes);
+            return;
+        }
+        if constexpr (16 % sizeof(T) == 0 && alignof(T) == sizeof(T)) {
+            if (bytes >= simd::non_temporal_threshold()) {
+                unsigned char pattern[16];
+                for (size_t i = 0; i < 16; i += sizeof(T)) {
+                    std::memcpy(pattern + i, &value, sizeof(T));
+                }
+                if (simd::stream_pattern(reinterpret_cast<unsigned char*>(dst), bytes, pattern)) {
+                    return;
+                }
+            }
+        }
+        if constexpr (std::is_arithmetic_v<T>) {
+            // the compiler turns this into wide vector stores
+            std::fill_n(dst, n, value);
+        } else {
+            // replicate by doubling, so large structs are written by memcpy
+            std::memcpy(static_cast<void*>(dst), &value, sizeof(T));
+            size_t done = 1;
+            while (done < n) {
+                const size_t step = std::min(done, n - done);
+                std::memcpy(static_cast<void*>(dst + done), static_cast<const void*>(dst), step * sizeof(T));
+                done += step;
+            }
+        }
+    } else {
+        std::fill_n(dst, n, value);
+    }
+}
+
+#endif //SIMD_FILL_H
@@ -0,0 +1,17 @@
+#ifndef STRESS_CHECK_H
+#define STRESS_CHECK_H
+
+#include <cstdlib>
+#include <iostream>
+
+// assert() that stays on in Release builds: prints the failed condition
+// and exits with status 1, so ctest reports the run as failed
+#define STRESS_CHECK(condition)                                                         \
+    do {                                                                                \
+        if (!(condition)) {                                                             \
+            std::cerr << __FILE__ << ':' << __LINE__ << ": check failed: " #condition "\n"; \
+            std::exit(1);                                                               \
+        }                                                                               \
+    } while (false)
+
+#endif //STRESS_CHECK_H
@@ -0,0 +1,102 @@
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../my_concurrent_vector.h"
+#include "stress_check.h"
+
+// Many threads append to one my_concurrent_vector at once while a reader
+// takes snapshots. Every value must land exactly once, references returned
+// by emplace_back must stay valid, and snapshots may only show finished
+// elements. Build with ENABLE_TSan to check the memory ordering as well.
+
+constexpr int writer_count = 8;
+constexpr int rounds = 20;
+
+// a value tagged with its writer, heavy enough to span several segments
+struct tagged {
+    static constexpr uint64_t poison = 0xDEADBEEFDEADBEEFull;
+    uint64_t value = poison;
+    std::string label;
+
+    explicit tagged (const uint64_t v) : value(v), label(std::to_string(v)) {
+        // every 97th value fails to construct and must never be seen
+        if (v % 97 == 0) {
+            throw std::runtime_error("rejected");
+        }
+    }
+};
+
+[[nodiscard]] static bool well_formed (const tagged& t) {
+    return t.value != tagged::poison && t.value % 97 != 0 && t.label == std::to_string(t.value);
+}
+
+static void run_round (const int per_writer) {
+    my_concurrent_vector<tagged> v;
+    std::atomic<int> started {0};
+    std::atomic<bool> writers_done {false};
+    std::vector<std::vector<const tagged*>> returned(writer_count);
+
+    std::vector<std::thread> writers;
+    for (int w = 0; w < writer_count; ++w) {
+        writers.emplace_back([&, w] {
+            started.fetch_add(1);
+            while (started.load() < writer_count) {} // start together to race on segment 0
+            for (int i = 0; i < per_writer; ++i) {
+                const auto value = static_cast<uint64_t>(w) * per_writer + i;
+                try {
+                    returned[w].push_back(&v.emplace_back(value));
+                } catch (const std::runtime_error&) {
+                    STRESS_CHECK(value % 97 == 0);
+                }
+            }
+        });
+    }
+    std::thread reader([&] {
+        while (!writers_done.load()) {
+            const auto snapshot = v.snapshot();
+            STRESS_CHECK(snapshot.size() <= v.size());
+            for (const tagged& t : snapshot) {
+                STRESS_CHECK(well_formed(t));
+            }
+        }
+    });
+    for (auto& t : writers) {
+        t.join();
+    }
+    writers_done.store(true);
+    reader.join();
+
+    const auto total = static_cast<size_t>(writer_count) * per_writer;
+    STRESS_CHECK(v.size() == total);
+    std::vector<unsigned char> seen(total, 0);
+    for (const tagged& t : v.snapshot()) {
+        STRESS_CHECK(well_formed(t));
+        STRESS_CHECK(seen[t.value]++ == 0);
+    }
+    for (size_t value = 0; value < total; ++value) {
+        STRESS_CHECK(seen[value] == (value % 97 == 0 ? 0 : 1));
+    }
+    // elements never move, so the references handed out are still good
+    for (int w = 0; w < writer_count; ++w) {
+        size_t next = static_cast<size_t>(w) * per_writer;
+        for (const tagged* t : returned[w]) {
+            while (next % 97 == 0) {
+                ++next;
+            }
+            STRESS_CHECK(t->value == next++);
+        }
+    }
+}
+
+int main () {
+    for (int round = 0; round < rounds; ++round) {
+        // alternate between a few segments and many
+        run_round(round % 2 == 0 ? 64 : 4096);
+    }
+    std::cout << "my_concurrent_vector stress: ok\n";
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include "../my_parallel.h"
+#include "../my_vector.h"
+#include "stress_check.h"
+
+// parallel_sort and parallel_stable_sort against std::sort and
+// std::stable_sort, on trivially copyable elements and on std::string,
+// whose moved-from state is visible to a merge that reads a moved element.
+// Sizes straddle parallel_serial_cutoff and uneven chunk splits, and the
+// pools range from a lone caller to more threads than cores.
+
+template <typename E>
+static E make_element (const uint64_t x) {
+    if constexpr (std::is_same_v<E, std::string>) {
+        return "key " + std::to_string(x % 100'000) + " padded past the small string buffer";
+    } else {
+        return static_cast<E>(x % 100'000);
+    }
+}
+
+template <typename E>
+static void check_sorts (const size_t n, thread_pool& pool) {
+    std::mt19937_64 rng(n);
+    my_vector<E> v;
+    for (size_t i = 0; i < n; ++i) {
+        v.push_back(make_element<E>(rng()));
+    }
+
+    my_vector<E> expected = v;
+    std::sort(expected.begin(), expected.end());
+    my_vector<E> sorted = v;
+    parallel_sort(sorted, std::less<>(), pool);
+    STRESS_CHECK(sorted == expected);
+
+    // stability: order pairs by key only, the index must stay in input order
+    my_vector<std::pair<E, size_t>> tagged;
+    for (size_t i = 0; i < n; ++i) {
+        tagged.push_back({v[i], i});
+    }
+    const auto by_key = [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    };
+    my_vector<std::pair<E, size_t>> stable_expected = tagged;
+    std::stable_sort(stable_expected.begin(), stable_expected.end(), by_key);
+    parallel_stable_sort(tagged, by_key, pool);
+    STRESS_CHECK(tagged == stable_expected);
+}
+
+int main () {
+    for (const size_t workers : {0, 1, 4}) {
+        thread_pool pool(workers);
+        for (const size_t n : {1000, 16384, 17000, 20000, 30000, 50000, 65536, 100'003}) {
+            check_sorts<long>(n, pool);
+            check_sorts<double>(n, pool);
+            check_sorts<std::string>(n, pool);
+        }
+    }
+    std::cout << "parallel sort stress: ok\n";
+    return 0;
+}
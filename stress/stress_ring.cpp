@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../my_ring.h"
+#include "stress_check.h"
+
+// Producers and consumers move values through a small my_ring with push_n
+// and pop_n (plus single pushes and pops). Every value must arrive exactly
+// once. spsc must keep the producer's order; in mpmc each consumer must see
+// any one producer's values in the order they were pushed. Build with
+// ENABLE_TSan to check the memory ordering as well.
+
+constexpr uint64_t per_producer = 100000;
+constexpr size_t max_batch = 13; // odd, so batches wrap around the ring
+
+// values carry their producer in the high bits
+[[nodiscard]] static uint64_t make_value (const uint64_t producer, const uint64_t i) {
+    return producer << 32 | i;
+}
+
+// the element types under test: a plain integer, and a string long enough
+// to live on the heap, so a lost or doubled destructor shows up under ASan
+struct as_integer {
+    using type = uint64_t;
+    static type encode (const uint64_t v) {
+        return v;
+    }
+    static uint64_t decode (const type& v) {
+        return v;
+    }
+};
+struct as_string {
+    using type = std::string;
+    static type encode (const uint64_t v) {
+        return std::to_string(v) + " padded past the small string buffer";
+    }
+    static uint64_t decode (const type& v) {
+        return std::stoull(v);
+    }
+};
+
+template <typename Codec, ring_mode Mode>
+static void run (const int producers, const int consumers) {
+    using T = typename Codec::type;
+    auto ring = std::make_unique<my_ring<T, 64, Mode>>();
+    const uint64_t total = per_producer * static_cast<uint64_t>(producers);
+    std::atomic<uint64_t> received {0};
+    std::vector<std::vector<uint64_t>> logs(static_cast<size_t>(consumers));
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            std::vector<T> batch;
+            uint64_t next = 0;
+            while (next < per_producer) {
+                const size_t want = std::min<uint64_t>(next % max_batch + 1, per_producer - next);
+                if (want == 1) {
+                    if (ring->try_push(Codec::encode(make_value(p, next)))) {
+                        ++next;
+                    } else {
+                        std::this_thread::yield();
+                    }
+                    continue;
+                }
+                batch.clear();
+                for (size_t i = 0; i < want; ++i) {
+                    batch.push_back(Codec::encode(make_value(p, next + i)));
+                }
+                const size_t pushed = ring->push_n(std::make_move_iterator(batch.begin()), want);
+                if (pushed == 0) {
+                    std::this_thread::yield();
+                }
+                next += pushed;
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&, c] {
+            std::vector<T> batch(max_batch);
+            auto& log = logs[static_cast<size_t>(c)];
+            size_t round = 0;
+            while (received.load() < total) {
+                size_t popped;
+                if (++round % 5 == 0) {
+                    auto single = ring->try_pop();
+                    popped = single.has_value() ? 1 : 0;
+                    if (single) {
+                        log.push_back(Codec::decode(*single));
+                    }
+                } else {
+                    popped = ring->pop_n(batch.begin(), round % max_batch + 1);
+                    for (size_t i = 0; i < popped; ++i) {
+                        log.push_back(Codec::decode(batch[i]));
+                    }
+                }
+                if (popped == 0) {
+                    std::this_thread::yield();
+                }
+                received.fetch_add(popped);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    STRESS_CHECK(received.load() == total);
+    STRESS_CHECK(ring->is_empty_approx());
+    std::vector<unsigned char> seen(total, 0);
+    for (const auto& log : logs) {
+        std::vector<int64_t> last(static_cast<size_t>(producers), -1);
+        for (const uint64_t v : log) {
+            const uint64_t producer = v >> 32;
+            const uint64_t i = v & 0xFFFFFFFF;
+            STRESS_CHECK(producer < static_cast<uint64_t>(producers) && i < per_producer);
+            STRESS_CHECK(seen[producer * per_producer + i]++ == 0);
+            // positions are claimed in increasing order on both sides
+            STRESS_CHECK(static_cast<int64_t>(i) > last[producer]);
+            if (Mode == ring_mode::spsc) {
+                STRESS_CHECK(static_cast<int64_t>(i) == last[producer] + 1);
+            }
+            last[producer] = static_cast<int64_t>(i);
+        }
+    }
+    STRESS_CHECK(std::count(seen.begin(), seen.end(), 1) == static_cast<std::ptrdiff_t>(total));
+}
+
+// elements still queued when the ring goes away are destroyed with it
+template <ring_mode Mode>
+static void leftovers () {
+    my_ring<std::string, 8, Mode> ring;
+    for (int i = 0; i < 20; ++i) {
+        std::string ignored;
+        ring.try_pop(ignored);
+        ring.try_push(as_string::encode(static_cast<uint64_t>(i)));
+        ring.try_push(as_string::encode(static_cast<uint64_t>(i)));
+    }
+    STRESS_CHECK(ring.size_approx() == 8);
+}
+
+int main () {
+    run<as_integer, ring_mode::spsc>(1, 1);
+    run<as_string, ring_mode::spsc>(1, 1);
+    run<as_integer, ring_mode::mpmc>(4, 4);
+    run<as_string, ring_mode::mpmc>(4, 4);
+    run<as_integer, ring_mode::mpmc>(1, 6);
+    run<as_integer, ring_mode::mpmc>(6, 1);
+    leftovers<ring_mode::spsc>();
+    leftovers<ring_mode::mpmc>();
+    std::cout << "my_ring stress: ok\n";
+    return 0;
+}
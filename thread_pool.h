@@ -0,0 +1,206 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing pool for the fork-join loops in my_parallel.h. Every
+// worker owns a deque: it pops its own tasks from the back and steals
+// from the front of the others when it runs dry. The thread calling
+// parallel_for also executes tasks until its loop is done, so nested
+// parallel_for calls never block a worker.
+class thread_pool {
+    using task = std::function<void()>;
+
+    struct worker_queue {
+        std::mutex m;
+        std::deque<task> tasks;
+    };
+
+    std::vector<std::unique_ptr<worker_queue>> queues_m;
+    std::vector<std::thread> threads_m;
+    std::atomic<bool> stop_m {false};
+    std::atomic<size_t> pending_m {0};
+    std::atomic<size_t> next_queue_m {0};
+    std::mutex sleep_m;
+    std::condition_variable wake_m;
+
+    static constexpr size_t not_a_worker = static_cast<size_t>(-1);
+
+    // index of the calling thread's queue in the pool it belongs to
+    static size_t& current_index () {
+        thread_local size_t index = not_a_worker;
+        return index;
+    }
+    static thread_pool*& current_pool () {
+        thread_local thread_pool* pool = nullptr;
+        return pool;
+    }
+
+    bool try_pop (const size_t self, task& out) {
+        const size_t n = queues_m.size();
+        if (n == 0 || pending_m.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+        if (self < n) {
+            worker_queue& own = *queues_m[self];
+            std::lock_guard<std::mutex> lock(own.m);
+            if (!own.tasks.empty()) {
+                out = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                pending_m.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        const size_t start = self < n ? self + 1 : next_queue_m.load(std::memory_order_relaxed);
+        for (size_t k = 0; k < n; ++k) {
+            worker_queue& victim = *queues_m[(start + k) % n];
+            std::lock_guard<std::mutex> lock(victim.m);
+            if (!victim.tasks.empty()) {
+                out = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                pending_m.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void worker_loop (const size_t index) {
+        current_index() = index;
+        current_pool() = this;
+        task t;
+        while (!stop_m.load(std::memory_order_acquire)) {
+            if (try_pop(index, t)) {
+                t();
+                t = nullptr;
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_m);
+            wake_m.wait(lock, [this] {
+                return stop_m.load(std::memory_order_acquire) || pending_m.load(std::memory_order_acquire) != 0;
+            });
+        }
+    }
+
+    void submit (task t) {
+        const size_t self = current_pool() == this ? current_index() : not_a_worker;
+        const size_t target = self != not_a_worker
+                ? self
+                : next_queue_m.fetch_add(1, std::memory_order_relaxed) % queues_m.size();
+        // counted before it is visible, so pending_m never underflows
+        pending_m.fetch_add(1, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(queues_m[target]->m);
+            queues_m[target]->tasks.push_back(std::move(t));
+        }
+        {
+            // pairs with the predicate check in worker_loop, so no wakeup is lost
+            std::lock_guard<std::mutex> lock(sleep_m);
+        }
+        wake_m.notify_one();
+    }
+
+    // runs one queued task on the calling thread, if there is any
+    bool run_one () {
+        const size_t self = current_pool() == this ? current_index() : not_a_worker;
+        task t;
+        if (try_pop(self, t)) {
+            t();
+            return true;
+        }
+        return false;
+    }
+
+public:
+    // threads counts the workers; the calling thread always takes part too
+    explicit thread_pool (const size_t threads = default_workers()) {
+        for (size_t i = 0; i < threads; ++i) {
+            queues_m.push_back(std::make_unique<worker_queue>());
+        }
+        for (size_t i = 0; i < threads; ++i) {
+            threads_m.emplace_back(&thread_pool::worker_loop, this, i);
+        }
+    }
+    thread_pool (const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_m);
+            stop_m.store(true, std::memory_order_release);
+        }
+        wake_m.notify_all();
+        for (auto& t : threads_m) {
+            t.join();
+        }
+    }
+
+    [[nodiscard]] static size_t default_workers () {
+        const size_t hw = std::thread::hardware_concurrency();
+        return hw > 1 ? hw - 1 : 0;
+    }
+
+    // shared pool with one worker per hardware thread besides the caller
+    static thread_pool& global () {
+        static thread_pool pool;
+        return pool;
+    }
+
+    // number of threads that execute a parallel_for, the caller included
+    [[nodiscard]] size_t concurrency () const {
+        return threads_m.size() + 1;
+    }
+
+    // calls f(i) for every i in [0, n) and returns when all are done;
+    // the first exception thrown by f is rethrown here
+    template <typename F>
+    void parallel_for (const size_t n, F&& f) {
+        if (n == 0) {
+            return;
+        }
+        if (n == 1 || threads_m.empty()) {
+            for (size_t i = 0; i < n; ++i) {
+                f(i);
+            }
+            return;
+        }
+        std::atomic<size_t> remaining {n - 1};
+        std::exception_ptr error;
+        std::mutex error_m;
+        auto guarded = [&](const size_t i) {
+            try {
+                f(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_m);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        };
+        for (size_t i = 1; i < n; ++i) {
+            submit([&guarded, &remaining, i] {
+                guarded(i);
+                remaining.fetch_sub(1, std::memory_order_acq_rel);
+            });
+        }
+        guarded(0);
+        while (remaining.load(std::memory_order_acquire) != 0) {
+            if (!run_one()) {
+                std::this_thread::yield();
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+#endif //THREAD_POOL_H
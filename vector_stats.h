@@ -0,0 +1,147 @@
+#ifndef VECTOR_STATS_H
+#define VECTOR_STATS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <typeinfo>
+#include <vector>
+
+// Allocation and growth counters for my_vector, kept per vector type.
+// Compiled in only with MY_VECTOR_STATS defined (ENABLE_VECTOR_STATS in
+// CMakeLists.txt); otherwise every hook is an empty if constexpr branch.
+
+#ifdef MY_VECTOR_STATS
+inline constexpr bool vector_stats_enabled = true;
+#else
+inline constexpr bool vector_stats_enabled = false;
+#endif
+
+struct vector_stats_snapshot {
+    const char* type_name;
+    uint64_t allocations;
+    uint64_t reallocations;
+    // blocks grown in place by the allocator's expand() hook; no new block
+    // and no element moves, so they count toward neither of the above
+    uint64_t expansions;
+    uint64_t bytes_allocated;
+    uint64_t bytes_copied;
+    uint64_t bytes_moved;
+    uint64_t peak_capacity;
+    // final capacity and size summed over every destroyed vector; their
+    // ratio is the average over-allocation
+    uint64_t sampled_capacity;
+    uint64_t sampled_size;
+
+    [[nodiscard]] double waste_ratio () const {
+        return sampled_size == 0 ? 0.0 : static_cast<double>(sampled_capacity) / static_cast<double>(sampled_size);
+    }
+};
+
+using vector_stats_source = vector_stats_snapshot (*)();
+
+inline std::mutex& vector_stats_registry_mutex () {
+    static std::mutex m;
+    return m;
+}
+inline std::vector<vector_stats_source>& vector_stats_registry () {
+    static std::vector<vector_stats_source> sources;
+    return sources;
+}
+
+// snapshots of every vector type that has recorded anything so far
+inline std::vector<vector_stats_snapshot> all_vector_stats () {
+    std::lock_guard<std::mutex> lock(vector_stats_registry_mutex());
+    std::vector<vector_stats_snapshot> result;
+    for (const vector_stats_source source : vector_stats_registry()) {
+        result.push_back(source());
+    }
+    return result;
+}
+
+template <typename Vector>
+class vector_stats {
+    struct counters {
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> reallocations{0};
+        std::atomic<uint64_t> expansions{0};
+        std::atomic<uint64_t> bytes_allocated{0};
+        std::atomic<uint64_t> bytes_copied{0};
+        std::atomic<uint64_t> bytes_moved{0};
+        std::atomic<uint64_t> peak_capacity{0};
+        std::atomic<uint64_t> sampled_capacity{0};
+        std::atomic<uint64_t> sampled_size{0};
+
+        counters () {
+            std::lock_guard<std::mutex> lock(vector_stats_registry_mutex());
+            vector_stats_registry().push_back(&vector_stats::snapshot);
+        }
+    };
+
+    static counters& get () {
+        static counters c;
+        return c;
+    }
+    static void add (std::atomic<uint64_t>& counter, const uint64_t value) {
+        counter.fetch_add(value, std::memory_order_relaxed);
+    }
+    static void raise_peak (counters& c, const uint64_t capacity) {
+        uint64_t peak = c.peak_capacity.load(std::memory_order_relaxed);
+        while (capacity > peak && !c.peak_capacity.compare_exchange_weak(peak, capacity, std::memory_order_relaxed)) {}
+    }
+
+public:
+    static void on_allocation (const size_t capacity, const size_t bytes) {
+        counters& c = get();
+        add(c.allocations, 1);
+        add(c.bytes_allocated, bytes);
+        raise_peak(c, capacity);
+    }
+    static void on_reallocation () {
+        add(get().reallocations, 1);
+    }
+    static void on_expansion (const size_t capacity) {
+        counters& c = get();
+        add(c.expansions, 1);
+        raise_peak(c, capacity);
+    }
+    static void on_copy (const size_t bytes) {
+        add(get().bytes_copied, bytes);
+    }
+    static void on_move (const size_t bytes) {
+        add(get().bytes_moved, bytes);
+    }
+    static void sample (const size_t capacity, const size_t size) {
+        if (capacity != 0) {
+            counters& c = get();
+            add(c.sampled_capacity, capacity);
+            add(c.sampled_size, size);
+        }
+    }
+
+    static vector_stats_snapshot snapshot () {
+        const counters& c = get();
+        return {
+            typeid(Vector).name(),
+            c.allocations.load(std::memory_order_relaxed),
+            c.reallocations.load(std::memory_order_relaxed),
+            c.expansions.load(std::memory_order_relaxed),
+            c.bytes_allocated.load(std::memory_order_relaxed),
+            c.bytes_copied.load(std::memory_order_relaxed),
+            c.bytes_moved.load(std::memory_order_relaxed),
+            c.peak_capacity.load(std::memory_order_relaxed),
+            c.sampled_capacity.load(std::memory_order_relaxed),
+            c.sampled_size.load(std::memory_order_relaxed),
+        };
+    }
+    static void reset () {
+        counters& c = get();
+        for (auto* counter : {&c.allocations, &c.reallocations, &c.expansions, &c.bytes_allocated, &c.bytes_copied,
+                              &c.bytes_moved, &c.peak_capacity, &c.sampled_capacity, &c.sampled_size}) {
+            counter->store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+#endif //VECTOR_STATS_H